@@ -0,0 +1,47 @@
+#ifndef AST_CONTEXT_H
+#define AST_CONTEXT_H
+
+#include "../arena.h"
+
+#include <cstddef>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+// Child lists of a node, copied into the ASTContext.
+template <typename T>
+using NodeList = Span<T>;
+
+// Owns a syntax tree built by the HEADERS/ parser. Nodes and child lists
+// go into the same Arena the top-level compiler uses and are freed with the
+// context, never one by one. What this parser needs on top of that is
+// names: its nodes carry text rather than interned symbols, so the context
+// keeps one copy of each distinct name and hands out views of it.
+class ASTContext {
+public:
+    ASTContext() = default;
+    ASTContext(const ASTContext&) = delete;
+    ASTContext& operator=(const ASTContext&) = delete;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        return arena.make<T>(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    NodeList<T> list(const T* items, size_t count) {
+        return arena.copy(items, count);
+    }
+
+    // A view of `text` that lives as long as the context; equal texts get
+    // the same view, so names can be compared by pointer.
+    std::string_view intern(std::string_view text);
+
+    size_t bytesUsed() const { return arena.bytesAllocated(); }
+
+private:
+    Arena arena;
+    std::unordered_set<std::string_view> names;
+};
+
+#endif // AST_CONTEXT_H
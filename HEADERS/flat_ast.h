@@ -0,0 +1,123 @@
+#ifndef FLAT_AST_H
+#define FLAT_AST_H
+
+#include "parser.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using NodeIndex = uint32_t;
+
+// The tree under an ASTNode, flattened into one array of nodes in
+// pre-order and stored column by column: a walk over the whole tree, or
+// over any subtree, is a linear scan of the columns it reads.
+//
+// A node's subtree is [i, end(i)); its first child, if any, is i + 1 and
+// each further child starts at the end of the one before. Children sit in
+// fixed slots, and an absent child (a missing Otherwise branch or For
+// clause, an expression that failed to parse) takes its slot as an EMPTY
+// node; PARAMETER nodes carry the location of their function:
+//   BLOCK                   statements
+//   FUNCTION_DECL,
+//   NORETURN_FUNC           one PARAMETER per parameter, then the body
+//   VARIABLE_DECL           initializer
+//   IF_STMT                 condition, then, else
+//   WHILE_STMT,
+//   REPEATWHEN_STMT         condition, body
+//   FOR_STMT                initializer, condition, increment, body
+//   RETURN_STMT             value
+//   BINARY_EXPR             left, right
+//   UNARY_EXPR              operand
+//
+// Names and literal text are the views held by the original nodes, so the
+// ASTContext the tree was built in must outlive this.
+class FlatAST {
+public:
+    // Visits the child indices of one node.
+    class ChildIterator {
+    public:
+        ChildIterator(const FlatAST* ast, NodeIndex at) : ast(ast), at(at) {}
+        NodeIndex operator*() const { return at; }
+        ChildIterator& operator++() { at = ast->ends[at]; return *this; }
+        bool operator==(const ChildIterator& other) const { return at == other.at; }
+        bool operator!=(const ChildIterator& other) const { return at != other.at; }
+
+    private:
+        const FlatAST* ast;
+        NodeIndex at;
+    };
+
+    struct ChildRange {
+        ChildIterator first;
+        ChildIterator last;
+        ChildIterator begin() const { return first; }
+        ChildIterator end() const { return last; }
+    };
+
+    // Visits a run of node indices in order.
+    class IndexIterator {
+    public:
+        explicit IndexIterator(NodeIndex at) : at(at) {}
+        NodeIndex operator*() const { return at; }
+        IndexIterator& operator++() { ++at; return *this; }
+        bool operator==(const IndexIterator& other) const { return at == other.at; }
+        bool operator!=(const IndexIterator& other) const { return at != other.at; }
+
+    private:
+        NodeIndex at;
+    };
+
+    struct IndexRange {
+        NodeIndex first;
+        NodeIndex last;
+        IndexIterator begin() const { return IndexIterator(first); }
+        IndexIterator end() const { return IndexIterator(last); }
+    };
+
+    FlatAST() = default;
+    // Converts the tree under `root`, which becomes node 0; a null root
+    // gives an empty FlatAST.
+    explicit FlatAST(const ASTNode* root);
+
+    size_t size() const { return types.size(); }
+    bool empty() const { return types.empty(); }
+
+    NodeType type(NodeIndex node) const { return types[node]; }
+    // The operator of a BINARY_EXPR or UNARY_EXPR, the type of a LITERAL,
+    // VARIABLE_DECL or PARAMETER, the return type of a FUNCTION_DECL, and
+    // ERROR for everything else.
+    TokenType op(NodeIndex node) const { return ops[node]; }
+    int line(NodeIndex node) const { return lines[node]; }
+    int column(NodeIndex node) const { return columns[node]; }
+    // The name of a declaration, parameter or IDENTIFIER, or the text of a
+    // LITERAL; empty for everything else.
+    std::string_view text(NodeIndex node) const { return texts[node]; }
+
+    // One past the last node of the subtree under `node`.
+    NodeIndex end(NodeIndex node) const { return ends[node]; }
+    ChildRange children(NodeIndex node) const {
+        return {ChildIterator(this, node + 1), ChildIterator(this, ends[node])};
+    }
+    // The child in slot `slot`; it must exist.
+    NodeIndex child(NodeIndex node, size_t slot) const;
+    size_t childCount(NodeIndex node) const;
+
+    // `node` and everything under it, in pre-order.
+    IndexRange subtree(NodeIndex node) const { return {node, ends[node]}; }
+    IndexRange nodes() const { return {0, static_cast<NodeIndex>(size())}; }
+
+private:
+    NodeIndex add(NodeType type, TokenType op, int line, int column, std::string_view text = {});
+    void convert(const ASTNode* node);
+    void convertChildren(const ASTNode* node);
+    void addParameters(const ASTNode* function, const NodeList<Parameter>& parameters);
+
+    std::vector<NodeType> types;
+    std::vector<TokenType> ops;
+    std::vector<int> lines;
+    std::vector<int> columns;
+    std::vector<NodeIndex> ends;
+    std::vector<std::string_view> texts;
+};
+
+#endif // FLAT_AST_H
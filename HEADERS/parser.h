@@ -2,9 +2,10 @@
 #define PARSER_H
 
 #include "scanner.h"
-#include <memory>
+#include "ast_context.h"
 #include <vector>
 #include <string>
+#include <string_view>
 
 // AST Node Types
 enum class NodeType {
@@ -26,10 +27,17 @@ enum class NodeType {
     LITERAL,
     IDENTIFIER,
     CALL_EXPR,
-    ASSIGN_EXPR
+    ASSIGN_EXPR,
+    // Only in a FlatAST (see flat_ast.h)
+    PARAMETER,
+    EMPTY
 };
 
 // AST Node Base Class
+//
+// Nodes are created in an ASTContext and freed with it: children are plain
+// pointers into the same context and names and literal text are views of
+// strings interned there, so every node is trivially destructible.
 class ASTNode {
 public:
     NodeType type;
@@ -37,7 +45,6 @@ public:
     int column;
     
     ASTNode(NodeType t, int l, int c) : type(t), line(l), column(c) {}
-    virtual ~ASTNode() = default;
 };
 
 // Expression Node
@@ -50,33 +57,32 @@ public:
 class BinaryExprNode : public ExpressionNode {
 public:
     TokenType op;
-    std::unique_ptr<ExpressionNode> left;
-    std::unique_ptr<ExpressionNode> right;
+    ExpressionNode* left;
+    ExpressionNode* right;
     
-    BinaryExprNode(TokenType o, std::unique_ptr<ExpressionNode> l, 
-                  std::unique_ptr<ExpressionNode> r, int line, int col)
+    BinaryExprNode(TokenType o, ExpressionNode* l, ExpressionNode* r, int line, int col)
         : ExpressionNode(NodeType::BINARY_EXPR, line, col),
-          op(o), left(std::move(l)), right(std::move(r)) {}
+          op(o), left(l), right(r) {}
 };
 
 // Unary Expression Node
 class UnaryExprNode : public ExpressionNode {
 public:
     TokenType op;
-    std::unique_ptr<ExpressionNode> expr;
+    ExpressionNode* expr;
     
-    UnaryExprNode(TokenType o, std::unique_ptr<ExpressionNode> e, int line, int col)
+    UnaryExprNode(TokenType o, ExpressionNode* e, int line, int col)
         : ExpressionNode(NodeType::UNARY_EXPR, line, col),
-          op(o), expr(std::move(e)) {}
+          op(o), expr(e) {}
 };
 
 // Literal Node
 class LiteralNode : public ExpressionNode {
 public:
-    std::string value;
+    std::string_view value;
     TokenType literalType;
     
-    LiteralNode(const std::string& v, TokenType t, int line, int col)
+    LiteralNode(std::string_view v, TokenType t, int line, int col)
         : ExpressionNode(NodeType::LITERAL, line, col),
           value(v), literalType(t) {}
 };
@@ -84,46 +90,49 @@ public:
 // Identifier Node
 class IdentifierNode : public ExpressionNode {
 public:
-    std::string name;
+    std::string_view name;
     
-    IdentifierNode(const std::string& n, int line, int col)
+    IdentifierNode(std::string_view n, int line, int col)
         : ExpressionNode(NodeType::IDENTIFIER, line, col),
           name(n) {}
 };
 
+// Function parameter
+struct Parameter {
+    std::string_view name;
+    TokenType type;
+};
+
 // Function Declaration Node
 class FunctionDeclNode : public ASTNode {
 public:
-    std::string name;
+    std::string_view name;
     TokenType returnType;
-    std::vector<std::pair<std::string, TokenType>> parameters;
-    std::unique_ptr<ASTNode> body;
+    NodeList<Parameter> parameters;
+    ASTNode* body;
     
-    FunctionDeclNode(const std::string& n, TokenType rt, 
-                    std::vector<std::pair<std::string, TokenType>> p,
-                    std::unique_ptr<ASTNode> b, int line, int col)
+    FunctionDeclNode(std::string_view n, TokenType rt, NodeList<Parameter> p,
+                    ASTNode* b, int line, int col)
         : ASTNode(NodeType::FUNCTION_DECL, line, col),
-          name(n), returnType(rt), parameters(std::move(p)),
-          body(std::move(b)) {}
+          name(n), returnType(rt), parameters(p), body(b) {}
 };
 
 // Variable Declaration Node
 class VariableDeclNode : public ASTNode {
 public:
-    std::string name;
+    std::string_view name;
     TokenType varType;
-    std::unique_ptr<ExpressionNode> initializer;
+    ExpressionNode* initializer;
     
-    VariableDeclNode(const std::string& n, TokenType t,
-                    std::unique_ptr<ExpressionNode> i, int line, int col)
+    VariableDeclNode(std::string_view n, TokenType t, ExpressionNode* i, int line, int col)
         : ASTNode(NodeType::VARIABLE_DECL, line, col),
-          name(n), varType(t), initializer(std::move(i)) {}
+          name(n), varType(t), initializer(i) {}
 };
 
 // Block Node
 class BlockNode : public ASTNode {
 public:
-    std::vector<std::unique_ptr<ASTNode>> statements;
+    NodeList<ASTNode*> statements;
     
     BlockNode(int line, int col)
         : ASTNode(NodeType::BLOCK, line, col) {}
@@ -132,95 +141,90 @@ public:
 // If Statement Node
 class IfStmtNode : public ASTNode {
 public:
-    std::unique_ptr<ExpressionNode> condition;
-    std::unique_ptr<ASTNode> thenBranch;
-    std::unique_ptr<ASTNode> elseBranch;
+    ExpressionNode* condition;
+    ASTNode* thenBranch;
+    ASTNode* elseBranch;
     
-    IfStmtNode(std::unique_ptr<ExpressionNode> c,
-              std::unique_ptr<ASTNode> t,
-              std::unique_ptr<ASTNode> e, int line, int col)
+    IfStmtNode(ExpressionNode* c, ASTNode* t, ASTNode* e, int line, int col)
         : ASTNode(NodeType::IF_STMT, line, col),
-          condition(std::move(c)), thenBranch(std::move(t)),
-          elseBranch(std::move(e)) {}
+          condition(c), thenBranch(t), elseBranch(e) {}
 };
 
 // While Statement Node
 class WhileStmtNode : public ASTNode {
 public:
-    std::unique_ptr<ExpressionNode> condition;
-    std::unique_ptr<ASTNode> body;
+    ExpressionNode* condition;
+    ASTNode* body;
     
-    WhileStmtNode(std::unique_ptr<ExpressionNode> c,
-                 std::unique_ptr<ASTNode> b, int line, int col)
+    WhileStmtNode(ExpressionNode* c, ASTNode* b, int line, int col)
         : ASTNode(NodeType::WHILE_STMT, line, col),
-          condition(std::move(c)), body(std::move(b)) {}
+          condition(c), body(b) {}
 };
 
 // For Statement Node
 class ForStmtNode : public ASTNode {
 public:
-    std::unique_ptr<ASTNode> initializer;
-    std::unique_ptr<ExpressionNode> condition;
-    std::unique_ptr<ExpressionNode> increment;
-    std::unique_ptr<ASTNode> body;
+    ASTNode* initializer;
+    ExpressionNode* condition;
+    ExpressionNode* increment;
+    ASTNode* body;
     
-    ForStmtNode(std::unique_ptr<ASTNode> i,
-               std::unique_ptr<ExpressionNode> c,
-               std::unique_ptr<ExpressionNode> inc,
-               std::unique_ptr<ASTNode> b, int line, int col)
+    ForStmtNode(ASTNode* i, ExpressionNode* c, ExpressionNode* inc, ASTNode* b, int line, int col)
         : ASTNode(NodeType::FOR_STMT, line, col),
-          initializer(std::move(i)), condition(std::move(c)),
-          increment(std::move(inc)), body(std::move(b)) {}
+          initializer(i), condition(c), increment(inc), body(b) {}
 };
 
 // Return Statement Node
 class ReturnStmtNode : public ASTNode {
 public:
-    std::unique_ptr<ExpressionNode> value;
+    ExpressionNode* value;
     
-    ReturnStmtNode(std::unique_ptr<ExpressionNode> v, int line, int col)
+    ReturnStmtNode(ExpressionNode* v, int line, int col)
         : ASTNode(NodeType::RETURN_STMT, line, col),
-          value(std::move(v)) {}
+          value(v) {}
 };
 
 // NOReturn Function Node
 class NOReturnFuncNode : public ASTNode {
 public:
-    std::string name;
-    std::vector<std::pair<std::string, TokenType>> parameters;
-    std::unique_ptr<ASTNode> body;
+    std::string_view name;
+    NodeList<Parameter> parameters;
+    ASTNode* body;
     
-    NOReturnFuncNode(const std::string& n,
-                    std::vector<std::pair<std::string, TokenType>> p,
-                    std::unique_ptr<ASTNode> b, int line, int col)
+    NOReturnFuncNode(std::string_view n, NodeList<Parameter> p, ASTNode* b, int line, int col)
         : ASTNode(NodeType::NORETURN_FUNC, line, col),
-          name(n), parameters(std::move(p)), body(std::move(b)) {}
+          name(n), parameters(p), body(b) {}
 };
 
 // RepeatWhen Statement Node
 class RepeatWhenStmtNode : public ASTNode {
 public:
-    std::unique_ptr<ExpressionNode> condition;
-    std::unique_ptr<ASTNode> body;
+    ExpressionNode* condition;
+    ASTNode* body;
     
-    RepeatWhenStmtNode(std::unique_ptr<ExpressionNode> c,
-                      std::unique_ptr<ASTNode> b, int line, int col)
+    RepeatWhenStmtNode(ExpressionNode* c, ASTNode* b, int line, int col)
         : ASTNode(NodeType::REPEATWHEN_STMT, line, col),
-          condition(std::move(c)), body(std::move(b)) {}
+          condition(c), body(b) {}
 };
 
 // Parser Class
 class Parser {
 public:
-    Parser(Scanner& scanner);
-    std::unique_ptr<ASTNode> parse();
+    // Nodes are created in `context`.
+    Parser(Scanner& scanner, ASTContext& context);
+    // The root of the tree; it lives as long as the context.
+    ASTNode* parse();
     bool hasError() const;
     int getErrorCount() const;
     
 private:
     Scanner& scanner;
+    ASTContext& context;
     Token currentToken;
     int errorCount;
+    // Statements of the blocks being parsed, innermost last; a block copies
+    // its own into the context when it is complete.
+    std::vector<ASTNode*> pendingStatements;
     
     void advance();
     void match(TokenType expected);
@@ -228,30 +232,24 @@ private:
     void reportMatch(const std::string& rule);
     
     // Parsing methods
-    std::unique_ptr<ASTNode> parseProgram();
-    std::unique_ptr<ASTNode> parseFunctionDecl();
-    std::unique_ptr<ASTNode> parseStatement();
-    std::unique_ptr<ASTNode> parseBlock();
-    std::unique_ptr<ASTNode> parseIfStmt();
-    std::unique_ptr<ASTNode> parseWhileStmt();
-    std::unique_ptr<ASTNode> parseForStmt();
-    std::unique_ptr<ASTNode> parseReturnStmt();
-    std::unique_ptr<ASTNode> parseRepeatWhenStmt();
-    std::unique_ptr<ASTNode> parseVariableDecl();
-    std::unique_ptr<ExpressionNode> parseExpression();
-    std::unique_ptr<ExpressionNode> parseAssignment();
-    std::unique_ptr<ExpressionNode> parseEquality();
-    std::unique_ptr<ExpressionNode> parseComparison();
-    std::unique_ptr<ExpressionNode> parseTerm();
-    std::unique_ptr<ExpressionNode> parseFactor();
-    std::unique_ptr<ExpressionNode> parseUnary();
-    std::unique_ptr<ExpressionNode> parsePrimary();
+    ASTNode* parseProgram();
+    ASTNode* parseFunctionDecl();
+    ASTNode* parseStatement();
+    BlockNode* parseBlock();
+    ASTNode* parseIfStmt();
+    ASTNode* parseWhileStmt();
+    ASTNode* parseForStmt();
+    ASTNode* parseReturnStmt();
+    ASTNode* parseRepeatWhenStmt();
+    ASTNode* parseVariableDecl();
+    ExpressionNode* parseExpression();
+    ExpressionNode* parseBinary(int above); // only operators that bind tighter than `above`
+    ExpressionNode* parseUnary();
+    ExpressionNode* parsePrimary();
     
     // Helper methods
     bool isTypeToken(TokenType type) const;
-    bool isBinaryOperator(TokenType type) const;
     bool isUnaryOperator(TokenType type) const;
-    int getOperatorPrecedence(TokenType type) const;
 };
 
 #endif // PARSER_H 
\ No newline at end of file
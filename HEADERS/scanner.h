@@ -4,7 +4,6 @@
 #include <string>
 #include <vector>
 #include <fstream>
-#include <unordered_map>
 #include <memory>
 #include <iostream>
 
@@ -100,9 +99,12 @@ private:
     int currentColumn;
     int errorCount;
     
-    std::unordered_map<std::string, TokenType> keywords;
+    // Input is read in blocks; unread bytes are buffer[bufferPos, bufferEnd).
+    static constexpr size_t blockSize = 64 * 1024;
+    std::vector<char> buffer;
+    size_t bufferPos;
+    size_t bufferEnd;
     
-    void initializeKeywords();
     Token scanToken();
     Token scanIdentifier();
     Token scanNumber();
@@ -110,9 +112,12 @@ private:
     Token scanOperator();
     Token scanComment();
     void skipWhitespace();
-    char peek(int offset = 0);
+    char peek(size_t offset = 0);
     char advance();
     bool isAtEnd();
+    bool fillBuffer(size_t needed);
+    void consume(size_t count);
+    std::string slice(size_t count) const;
     void handleInclude(const std::string& filename);
     
     // Error handling
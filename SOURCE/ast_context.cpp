@@ -0,0 +1,11 @@
+#include "../HEADERS/ast_context.h"
+
+#include <cstring>
+
+std::string_view ASTContext::intern(std::string_view text) {
+    auto found = names.find(text);
+    if (found != names.end()) return *found;
+    char* copy = static_cast<char*>(arena.allocate(text.size(), 1));
+    if (!text.empty()) std::memcpy(copy, text.data(), text.size());
+    return *names.insert(std::string_view(copy, text.size())).first;
+}
@@ -0,0 +1,149 @@
+#include "../HEADERS/flat_ast.h"
+
+FlatAST::FlatAST(const ASTNode* root) {
+    if (root) convert(root);
+}
+
+NodeIndex FlatAST::add(NodeType type, TokenType op, int line, int column, std::string_view text) {
+    NodeIndex index = static_cast<NodeIndex>(types.size());
+    types.push_back(type);
+    ops.push_back(op);
+    lines.push_back(line);
+    columns.push_back(column);
+    ends.push_back(index + 1);
+    texts.push_back(text);
+    return index;
+}
+
+void FlatAST::convert(const ASTNode* node) {
+    if (!node) {
+        // Takes the slot of an absent child; there is no location to give.
+        add(NodeType::EMPTY, TokenType::ERROR, 0, 0);
+        return;
+    }
+
+    TokenType op = TokenType::ERROR;
+    std::string_view text;
+    switch (node->type) {
+        case NodeType::FUNCTION_DECL: {
+            auto func = static_cast<const FunctionDeclNode*>(node);
+            op = func->returnType;
+            text = func->name;
+            break;
+        }
+        case NodeType::NORETURN_FUNC:
+            text = static_cast<const NOReturnFuncNode*>(node)->name;
+            break;
+        case NodeType::VARIABLE_DECL: {
+            auto decl = static_cast<const VariableDeclNode*>(node);
+            op = decl->varType;
+            text = decl->name;
+            break;
+        }
+        case NodeType::BINARY_EXPR:
+            op = static_cast<const BinaryExprNode*>(node)->op;
+            break;
+        case NodeType::UNARY_EXPR:
+            op = static_cast<const UnaryExprNode*>(node)->op;
+            break;
+        case NodeType::LITERAL: {
+            auto literal = static_cast<const LiteralNode*>(node);
+            op = literal->literalType;
+            text = literal->value;
+            break;
+        }
+        case NodeType::IDENTIFIER:
+            text = static_cast<const IdentifierNode*>(node)->name;
+            break;
+        default:
+            break;
+    }
+
+    NodeIndex index = add(node->type, op, node->line, node->column, text);
+    convertChildren(node);
+    ends[index] = static_cast<NodeIndex>(types.size());
+}
+
+void FlatAST::convertChildren(const ASTNode* node) {
+    switch (node->type) {
+        case NodeType::BLOCK:
+            for (const ASTNode* statement : static_cast<const BlockNode*>(node)->statements) {
+                convert(statement);
+            }
+            break;
+        case NodeType::FUNCTION_DECL: {
+            auto func = static_cast<const FunctionDeclNode*>(node);
+            addParameters(func, func->parameters);
+            convert(func->body);
+            break;
+        }
+        case NodeType::NORETURN_FUNC: {
+            auto func = static_cast<const NOReturnFuncNode*>(node);
+            addParameters(func, func->parameters);
+            convert(func->body);
+            break;
+        }
+        case NodeType::VARIABLE_DECL:
+            convert(static_cast<const VariableDeclNode*>(node)->initializer);
+            break;
+        case NodeType::IF_STMT: {
+            auto stmt = static_cast<const IfStmtNode*>(node);
+            convert(stmt->condition);
+            convert(stmt->thenBranch);
+            convert(stmt->elseBranch);
+            break;
+        }
+        case NodeType::WHILE_STMT: {
+            auto stmt = static_cast<const WhileStmtNode*>(node);
+            convert(stmt->condition);
+            convert(stmt->body);
+            break;
+        }
+        case NodeType::REPEATWHEN_STMT: {
+            auto stmt = static_cast<const RepeatWhenStmtNode*>(node);
+            convert(stmt->condition);
+            convert(stmt->body);
+            break;
+        }
+        case NodeType::FOR_STMT: {
+            auto stmt = static_cast<const ForStmtNode*>(node);
+            convert(stmt->initializer);
+            convert(stmt->condition);
+            convert(stmt->increment);
+            convert(stmt->body);
+            break;
+        }
+        case NodeType::RETURN_STMT:
+            convert(static_cast<const ReturnStmtNode*>(node)->value);
+            break;
+        case NodeType::BINARY_EXPR: {
+            auto expr = static_cast<const BinaryExprNode*>(node);
+            convert(expr->left);
+            convert(expr->right);
+            break;
+        }
+        case NodeType::UNARY_EXPR:
+            convert(static_cast<const UnaryExprNode*>(node)->expr);
+            break;
+        default:
+            break;
+    }
+}
+
+void FlatAST::addParameters(const ASTNode* function, const NodeList<Parameter>& parameters) {
+    for (const Parameter& parameter : parameters) {
+        add(NodeType::PARAMETER, parameter.type, function->line, function->column, parameter.name);
+    }
+}
+
+NodeIndex FlatAST::child(NodeIndex node, size_t slot) const {
+    NodeIndex at = node + 1;
+    for (; slot > 0; --slot) at = ends[at];
+    return at;
+}
+
+size_t FlatAST::childCount(NodeIndex node) const {
+    size_t count = 0;
+    for (NodeIndex at = node + 1; at < ends[node]; at = ends[at]) count++;
+    return count;
+}
@@ -1,9 +1,45 @@
 #include "parser.h"
+#include <array>
 #include <iostream>
 #include <stdexcept>
 using namespace std;
 
-Parser::Parser(Scanner& s) : scanner(s), errorCount(0) {
+namespace {
+
+// How tightly each binary operator binds, keyed on token type; 0 for
+// tokens that are not binary operators. Assignment is right-associative,
+// everything else left-associative.
+struct BindingPower {
+    unsigned char power = 0;
+    bool rightAssociative = false;
+};
+
+constexpr size_t tokenTypeCount = static_cast<size_t>(TokenType::END_OF_FILE) + 1;
+
+constexpr std::array<BindingPower, tokenTypeCount> buildBindingPowers() {
+    std::array<BindingPower, tokenTypeCount> table{};
+    auto set = [&table](TokenType type, BindingPower power) { table[static_cast<size_t>(type)] = power; };
+    set(TokenType::ASSIGN, {1, true});
+    set(TokenType::OR, {2});
+    set(TokenType::AND, {3});
+    set(TokenType::EQUAL, {4});
+    set(TokenType::NOT_EQUAL, {4});
+    set(TokenType::LESS, {5});
+    set(TokenType::LESS_EQUAL, {5});
+    set(TokenType::GREATER, {5});
+    set(TokenType::GREATER_EQUAL, {5});
+    set(TokenType::PLUS, {6});
+    set(TokenType::MINUS, {6});
+    set(TokenType::MULTIPLY, {7});
+    set(TokenType::DIVIDE, {7});
+    return table;
+}
+
+constexpr std::array<BindingPower, tokenTypeCount> bindingPowers = buildBindingPowers();
+
+} // namespace
+
+Parser::Parser(Scanner& s, ASTContext& c) : scanner(s), context(c), errorCount(0) {
     currentToken = scanner.getNextToken();
 }
 
@@ -29,7 +65,7 @@ void Parser::reportMatch(const std::string& rule) {
  cout << "Line : " << currentToken.line << " Matched                           Rule used: " << rule << "\n";
 }
 
-std::unique_ptr<ASTNode> Parser::parse() {
+ASTNode* Parser::parse() {
  cout << "\nParser Phase Output:\n";
     auto program = parseProgram();
     if (currentToken.type != TokenType::END_OF_FILE) {
@@ -42,8 +78,9 @@ std::unique_ptr<ASTNode> Parser::parse() {
     return program;
 }
 
-std::unique_ptr<ASTNode> Parser::parseProgram() {
-    auto program = std::make_unique<BlockNode>(currentToken.line, currentToken.column);
+ASTNode* Parser::parseProgram() {
+    auto program = context.create<BlockNode>(currentToken.line, currentToken.column);
+    size_t first = pendingStatements.size();
     
     while (currentToken.type != TokenType::END_OF_FILE) {
         if (currentToken.type == TokenType::SINGLE_COMMENT_START ||
@@ -55,7 +92,7 @@ std::unique_ptr<ASTNode> Parser::parseProgram() {
             auto funcDecl = parseFunctionDecl();
             if (funcDecl) {
                 reportMatch("fun-declaration");
-                program->statements.push_back(std::move(funcDecl));
+                pendingStatements.push_back(funcDecl);
             }
         } else {
             reportError("Expected function declaration");
@@ -63,10 +100,12 @@ std::unique_ptr<ASTNode> Parser::parseProgram() {
         }
     }
     
+    program->statements = context.list(pendingStatements.data() + first, pendingStatements.size() - first);
+    pendingStatements.resize(first);
     return program;
 }
 
-std::unique_ptr<ASTNode> Parser::parseFunctionDecl() {
+ASTNode* Parser::parseFunctionDecl() {
     bool isNOReturn = (currentToken.type == TokenType::NORETURN);
     if (isNOReturn) {
         advance();
@@ -87,12 +126,12 @@ std::unique_ptr<ASTNode> Parser::parseFunctionDecl() {
         return nullptr;
     }
     
- string name = currentToken.value;
+ std::string_view name = context.intern(currentToken.value);
     advance();
     
     match(TokenType::LEFT_PAREN);
     
- vector<std::pair<std::string, TokenType>> parameters;
+ vector<Parameter> parameters;
     while (currentToken.type != TokenType::RIGHT_PAREN) {
         if (!isTypeToken(currentToken.type)) {
             reportError("Expected parameter type");
@@ -107,7 +146,7 @@ std::unique_ptr<ASTNode> Parser::parseFunctionDecl() {
             break;
         }
         
-        parameters.emplace_back(currentToken.value, paramType);
+        parameters.push_back({context.intern(currentToken.value), paramType});
         advance();
         
         if (currentToken.type == TokenType::COMMA) {
@@ -125,18 +164,17 @@ std::unique_ptr<ASTNode> Parser::parseFunctionDecl() {
     
     match(TokenType::RIGHT_BRACE);
     
+    NodeList<Parameter> parameterList = context.list(parameters.data(), parameters.size());
     if (isNOReturn) {
-        return std::make_unique<NOReturnFuncNode>(name, std::move(parameters),
-                                             move(body), currentToken.line,
-                                                currentToken.column);
+        return context.create<NOReturnFuncNode>(name, parameterList, body,
+                                                currentToken.line, currentToken.column);
     }
     
-    return std::make_unique<FunctionDeclNode>(name, returnType, std::move(parameters),
-                                         move(body), currentToken.line,
-                                            currentToken.column);
+    return context.create<FunctionDeclNode>(name, returnType, parameterList, body,
+                                            currentToken.line, currentToken.column);
 }
 
-std::unique_ptr<ASTNode> Parser::parseStatement() {
+ASTNode* Parser::parseStatement() {
     switch (currentToken.type) {
         case TokenType::IF_TRUE:
             return parseIfStmt();
@@ -152,7 +190,7 @@ std::unique_ptr<ASTNode> Parser::parseStatement() {
             return parseBlock();
         case TokenType::BREAK:
         case TokenType::CONTINUE: {
-            auto stmt = std::make_unique<ASTNode>(
+            auto stmt = context.create<ASTNode>(
                 currentToken.type == TokenType::BREAK ? NodeType::BREAK_STMT : NodeType::CONTINUE_STMT,
                 currentToken.line, currentToken.column
             );
@@ -170,18 +208,21 @@ std::unique_ptr<ASTNode> Parser::parseStatement() {
     }
 }
 
-std::unique_ptr<ASTNode> Parser::parseBlock() {
-    auto block = std::make_unique<BlockNode>(currentToken.line, currentToken.column);
+BlockNode* Parser::parseBlock() {
+    auto block = context.create<BlockNode>(currentToken.line, currentToken.column);
+    size_t first = pendingStatements.size();
     
     while (currentToken.type != TokenType::RIGHT_BRACE &&
            currentToken.type != TokenType::END_OF_FILE) {
-        block->statements.push_back(parseStatement());
+        pendingStatements.push_back(parseStatement());
     }
     
+    block->statements = context.list(pendingStatements.data() + first, pendingStatements.size() - first);
+    pendingStatements.resize(first);
     return block;
 }
 
-std::unique_ptr<ASTNode> Parser::parseIfStmt() {
+ASTNode* Parser::parseIfStmt() {
     match(TokenType::IF_TRUE);
     match(TokenType::LEFT_PAREN);
     
@@ -194,7 +235,7 @@ std::unique_ptr<ASTNode> Parser::parseIfStmt() {
     
     match(TokenType::RIGHT_BRACE);
     
- unique_ptr<ASTNode> elseBranch = nullptr;
+ ASTNode* elseBranch = nullptr;
     if (currentToken.type == TokenType::OTHERWISE) {
         advance();
         match(TokenType::LEFT_BRACE);
@@ -202,12 +243,11 @@ std::unique_ptr<ASTNode> Parser::parseIfStmt() {
         match(TokenType::RIGHT_BRACE);
     }
     
-    return std::make_unique<IfStmtNode>(std::move(condition), std::move(thenBranch),
-                                   move(elseBranch), currentToken.line,
-                                      currentToken.column);
+    return context.create<IfStmtNode>(condition, thenBranch, elseBranch,
+                                      currentToken.line, currentToken.column);
 }
 
-std::unique_ptr<ASTNode> Parser::parseWhileStmt() {
+ASTNode* Parser::parseWhileStmt() {
     match(TokenType::WHILE);
     match(TokenType::LEFT_PAREN);
     
@@ -220,15 +260,15 @@ std::unique_ptr<ASTNode> Parser::parseWhileStmt() {
     
     match(TokenType::RIGHT_BRACE);
     
-    return std::make_unique<WhileStmtNode>(std::move(condition), std::move(body),
+    return context.create<WhileStmtNode>(condition, body,
                                          currentToken.line, currentToken.column);
 }
 
-std::unique_ptr<ASTNode> Parser::parseForStmt() {
+ASTNode* Parser::parseForStmt() {
     match(TokenType::FOR);
     match(TokenType::LEFT_PAREN);
     
- unique_ptr<ASTNode> initializer = nullptr;
+ ASTNode* initializer = nullptr;
     if (currentToken.type != TokenType::SEMICOLON) {
         if (isTypeToken(currentToken.type)) {
             initializer = parseVariableDecl();
@@ -240,13 +280,13 @@ std::unique_ptr<ASTNode> Parser::parseForStmt() {
         advance();
     }
     
- unique_ptr<ExpressionNode> condition = nullptr;
+ ExpressionNode* condition = nullptr;
     if (currentToken.type != TokenType::SEMICOLON) {
         condition = parseExpression();
     }
     match(TokenType::SEMICOLON);
     
- unique_ptr<ExpressionNode> increment = nullptr;
+ ExpressionNode* increment = nullptr;
     if (currentToken.type != TokenType::RIGHT_PAREN) {
         increment = parseExpression();
     }
@@ -256,26 +296,25 @@ std::unique_ptr<ASTNode> Parser::parseForStmt() {
     auto body = parseBlock();
     match(TokenType::RIGHT_BRACE);
     
-    return std::make_unique<ForStmtNode>(std::move(initializer), std::move(condition),
-                                    move(increment), std::move(body),
+    return context.create<ForStmtNode>(initializer, condition, increment, body,
                                        currentToken.line, currentToken.column);
 }
 
-std::unique_ptr<ASTNode> Parser::parseReturnStmt() {
+ASTNode* Parser::parseReturnStmt() {
     match(TokenType::RETURN);
     
- unique_ptr<ExpressionNode> value = nullptr;
+ ExpressionNode* value = nullptr;
     if (currentToken.type != TokenType::SEMICOLON) {
         value = parseExpression();
     }
     
     match(TokenType::SEMICOLON);
     
-    return std::make_unique<ReturnStmtNode>(std::move(value), currentToken.line,
+    return context.create<ReturnStmtNode>(value, currentToken.line,
                                           currentToken.column);
 }
 
-std::unique_ptr<ASTNode> Parser::parseVariableDecl() {
+ASTNode* Parser::parseVariableDecl() {
     TokenType varType = currentToken.type;
     advance();
     
@@ -284,10 +323,10 @@ std::unique_ptr<ASTNode> Parser::parseVariableDecl() {
         return nullptr;
     }
     
- string name = currentToken.value;
+ std::string_view name = context.intern(currentToken.value);
     advance();
     
- unique_ptr<ExpressionNode> initializer = nullptr;
+ ExpressionNode* initializer = nullptr;
     if (currentToken.type == TokenType::ASSIGN) {
         advance();
         initializer = parseExpression();
@@ -295,109 +334,49 @@ std::unique_ptr<ASTNode> Parser::parseVariableDecl() {
     
     match(TokenType::SEMICOLON);
     
-    return std::make_unique<VariableDeclNode>(name, varType, std::move(initializer),
+    return context.create<VariableDeclNode>(name, varType, initializer,
                                             currentToken.line, currentToken.column);
 }
 
-std::unique_ptr<ExpressionNode> Parser::parseExpression() {
-    return parseAssignment();
-}
-
-std::unique_ptr<ExpressionNode> Parser::parseAssignment() {
-    auto expr = parseEquality();
-    
-    if (currentToken.type == TokenType::ASSIGN) {
-        TokenType op = currentToken.type;
-        advance();
-        auto right = parseAssignment();
-        return std::make_unique<BinaryExprNode>(op, std::move(expr), std::move(right),
-                                              currentToken.line, currentToken.column);
-    }
-    
-    return expr;
+ExpressionNode* Parser::parseExpression() {
+    return parseBinary(0);
 }
 
-std::unique_ptr<ExpressionNode> Parser::parseEquality() {
-    auto expr = parseComparison();
-    
-    while (currentToken.type == TokenType::EQUAL ||
-           currentToken.type == TokenType::NOT_EQUAL) {
-        TokenType op = currentToken.type;
-        advance();
-        auto right = parseComparison();
-        expr = std::make_unique<BinaryExprNode>(op, std::move(expr), std::move(right),
-                                              currentToken.line, currentToken.column);
-    }
-    
-    return expr;
-}
-
-std::unique_ptr<ExpressionNode> Parser::parseComparison() {
-    auto expr = parseTerm();
-    
-    while (currentToken.type == TokenType::LESS ||
-           currentToken.type == TokenType::LESS_EQUAL ||
-           currentToken.type == TokenType::GREATER ||
-           currentToken.type == TokenType::GREATER_EQUAL) {
-        TokenType op = currentToken.type;
-        advance();
-        auto right = parseTerm();
-        expr = std::make_unique<BinaryExprNode>(op, std::move(expr), std::move(right),
-                                              currentToken.line, currentToken.column);
-    }
-    
-    return expr;
-}
-
-std::unique_ptr<ExpressionNode> Parser::parseTerm() {
-    auto expr = parseFactor();
-    
-    while (currentToken.type == TokenType::PLUS ||
-           currentToken.type == TokenType::MINUS) {
-        TokenType op = currentToken.type;
-        advance();
-        auto right = parseFactor();
-        expr = std::make_unique<BinaryExprNode>(op, std::move(expr), std::move(right),
-                                              currentToken.line, currentToken.column);
-    }
-    
-    return expr;
-}
-
-std::unique_ptr<ExpressionNode> Parser::parseFactor() {
+ExpressionNode* Parser::parseBinary(int above) {
     auto expr = parseUnary();
     
-    while (currentToken.type == TokenType::MULTIPLY ||
-           currentToken.type == TokenType::DIVIDE) {
+    for (;;) {
+        const BindingPower& binding = bindingPowers[static_cast<size_t>(currentToken.type)];
+        if (binding.power <= above) break;
         TokenType op = currentToken.type;
         advance();
-        auto right = parseUnary();
-        expr = std::make_unique<BinaryExprNode>(op, std::move(expr), std::move(right),
+        auto right = parseBinary(binding.rightAssociative ? binding.power - 1 : binding.power);
+        expr = context.create<BinaryExprNode>(op, expr, right,
                                               currentToken.line, currentToken.column);
     }
     
     return expr;
 }
 
-std::unique_ptr<ExpressionNode> Parser::parseUnary() {
+ExpressionNode* Parser::parseUnary() {
     if (isUnaryOperator(currentToken.type)) {
         TokenType op = currentToken.type;
         advance();
         auto expr = parseUnary();
-        return std::make_unique<UnaryExprNode>(op, std::move(expr),
+        return context.create<UnaryExprNode>(op, expr,
                                              currentToken.line, currentToken.column);
     }
     
     return parsePrimary();
 }
 
-std::unique_ptr<ExpressionNode> Parser::parsePrimary() {
+ExpressionNode* Parser::parsePrimary() {
     switch (currentToken.type) {
         case TokenType::INTEGER_LITERAL:
         case TokenType::FLOAT_LITERAL:
         case TokenType::STRING_LITERAL:
         case TokenType::BOOL_LITERAL: {
-            auto node = std::make_unique<LiteralNode>(currentToken.value,
+            auto node = context.create<LiteralNode>(context.intern(currentToken.value),
                                                     currentToken.type,
                                                     currentToken.line,
                                                     currentToken.column);
@@ -405,7 +384,7 @@ std::unique_ptr<ExpressionNode> Parser::parsePrimary() {
             return node;
         }
         case TokenType::IDENTIFIER: {
-            auto node = std::make_unique<IdentifierNode>(currentToken.value,
+            auto node = context.create<IdentifierNode>(context.intern(currentToken.value),
                                                        currentToken.line,
                                                        currentToken.column);
             advance();
@@ -428,39 +407,10 @@ bool Parser::isTypeToken(TokenType type) const {
            type == TokenType::STRING || type == TokenType::BOOL;
 }
 
-bool Parser::isBinaryOperator(TokenType type) const {
-    return type == TokenType::PLUS || type == TokenType::MINUS ||
-           type == TokenType::MULTIPLY || type == TokenType::DIVIDE ||
-           type == TokenType::EQUAL || type == TokenType::NOT_EQUAL ||
-           type == TokenType::LESS || type == TokenType::LESS_EQUAL ||
-           type == TokenType::GREATER || type == TokenType::GREATER_EQUAL ||
-           type == TokenType::AND || type == TokenType::OR;
-}
-
 bool Parser::isUnaryOperator(TokenType type) const {
     return type == TokenType::MINUS || type == TokenType::NOT;
 }
 
-int Parser::getOperatorPrecedence(TokenType type) const {
-    switch (type) {
-        case TokenType::MULTIPLY:
-        case TokenType::DIVIDE:
-            return 3;
-        case TokenType::PLUS:
-        case TokenType::MINUS:
-            return 2;
-        case TokenType::EQUAL:
-        case TokenType::NOT_EQUAL:
-        case TokenType::LESS:
-        case TokenType::LESS_EQUAL:
-        case TokenType::GREATER:
-        case TokenType::GREATER_EQUAL:
-            return 1;
-        default:
-            return 0;
-    }
-}
-
 bool Parser::hasError() const {
     return errorCount > 0;
 }
@@ -469,7 +419,7 @@ int Parser::getErrorCount() const {
     return errorCount;
 }
 
-std::unique_ptr<ASTNode> Parser::parseRepeatWhenStmt() {
+ASTNode* Parser::parseRepeatWhenStmt() {
     match(TokenType::REPEATWHEN);
     match(TokenType::LEFT_PAREN);
     
@@ -482,6 +432,6 @@ std::unique_ptr<ASTNode> Parser::parseRepeatWhenStmt() {
     
     match(TokenType::RIGHT_BRACE);
     
-    return std::make_unique<RepeatWhenStmtNode>(std::move(condition), std::move(body),
+    return context.create<RepeatWhenStmtNode>(condition, body,
                                               currentToken.line, currentToken.column);
 }
\ No newline at end of file
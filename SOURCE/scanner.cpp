@@ -1,39 +1,100 @@
 #include "../HEADERS/scanner.h"
+#include <algorithm>
+#include <array>
 #include <cctype>
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <string_view>
 
-Scanner::Scanner() : currentLine(1), currentColumn(0), errorCount(0) {
-    initializeKeywords();
+namespace {
+
+// Keywords are matched through a perfect hash built at compile time, so no
+// table is constructed per Scanner and a lookup does no heap work.
+struct KeywordEntry {
+    std::string_view text;
+    TokenType type;
+};
+
+constexpr KeywordEntry keywordList[] = {
+    {"NOReturn", TokenType::NORETURN},
+    {"RepeatWhen", TokenType::REPEATWHEN},
+    {"reg", TokenType::REG},
+    {"IfTrue", TokenType::IF_TRUE},
+    {"Otherwise", TokenType::OTHERWISE},
+    {"Imw", TokenType::IMW},
+    {"Float", TokenType::FLOAT},
+    {"String", TokenType::STRING},
+    {"Bool", TokenType::BOOL},
+    {"Void", TokenType::VOID},
+    {"Return", TokenType::RETURN},
+    {"While", TokenType::WHILE},
+    {"For", TokenType::FOR},
+    {"Break", TokenType::BREAK},
+    {"Continue", TokenType::CONTINUE}
+};
+
+constexpr size_t keywordTableSize = 32;
+constexpr size_t keywordMinLength = 3;
+constexpr size_t keywordMaxLength = 10;
+
+constexpr size_t keywordSlot(std::string_view text) {
+    return (text.size() + 5 * static_cast<unsigned char>(text.front()) +
+            8 * static_cast<unsigned char>(text.back())) % keywordTableSize;
+}
+
+constexpr bool keywordHashIsPerfect() {
+    for (size_t i = 0; i < std::size(keywordList); ++i) {
+        if (keywordList[i].text.size() < keywordMinLength ||
+            keywordList[i].text.size() > keywordMaxLength) return false;
+        for (size_t j = i + 1; j < std::size(keywordList); ++j) {
+            if (keywordSlot(keywordList[i].text) == keywordSlot(keywordList[j].text)) return false;
+        }
+    }
+    return true;
+}
+
+static_assert(keywordHashIsPerfect(), "keyword hash collision: adjust keywordSlot()");
+
+constexpr std::array<KeywordEntry, keywordTableSize> buildKeywordTable() {
+    std::array<KeywordEntry, keywordTableSize> table{};
+    for (KeywordEntry& slot : table) slot = {std::string_view(), TokenType::IDENTIFIER};
+    for (const KeywordEntry& entry : keywordList) table[keywordSlot(entry.text)] = entry;
+    return table;
 }
 
+constexpr std::array<KeywordEntry, keywordTableSize> keywordTable = buildKeywordTable();
+
+// Keyword type of `text`, or IDENTIFIER.
+constexpr TokenType lookupKeyword(std::string_view text) {
+    if (text.size() < keywordMinLength || text.size() > keywordMaxLength) return TokenType::IDENTIFIER;
+    const KeywordEntry& entry = keywordTable[keywordSlot(text)];
+    return entry.text == text ? entry.type : TokenType::IDENTIFIER;
+}
+
+} // namespace
+
+namespace {
+
+inline bool isIdentChar(char c) {
+    return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+inline bool isDigitChar(char c) {
+    return isdigit(static_cast<unsigned char>(c)) != 0;
+}
+
+} // namespace
+
+Scanner::Scanner()
+    : currentLine(1), currentColumn(0), errorCount(0), bufferPos(0), bufferEnd(0) {}
+
 Scanner::~Scanner() {
     if (currentFile.is_open()) {
         currentFile.close();
     }
 }
 
-void Scanner::initializeKeywords() {
-    keywords = {
-        {"NOReturn", TokenType::NORETURN},
-        {"RepeatWhen", TokenType::REPEATWHEN},
-        {"reg", TokenType::REG},
-        {"IfTrue", TokenType::IF_TRUE},
-        {"Otherwise", TokenType::OTHERWISE},
-        {"Imw", TokenType::IMW},
-        {"Float", TokenType::FLOAT},
-        {"String", TokenType::STRING},
-        {"Bool", TokenType::BOOL},
-        {"Void", TokenType::VOID},
-        {"Return", TokenType::RETURN},
-        {"While", TokenType::WHILE},
-        {"For", TokenType::FOR},
-        {"Break", TokenType::BREAK},
-        {"Continue", TokenType::CONTINUE}
-    };
-}
-
 bool Scanner::openFile(const std::string& filename) {
     if (currentFile.is_open()) {
         currentFile.close();
@@ -48,6 +109,7 @@ bool Scanner::openFile(const std::string& filename) {
     currentFilename = filename;
     currentLine = 1;
     currentColumn = 0;
+    bufferPos = bufferEnd = 0;
     return true;
 }
 
@@ -61,24 +123,25 @@ Token Scanner::getNextToken() {
     char c = peek();
     Token token(TokenType::ERROR, "", currentLine, currentColumn);
     
-    if (isalpha(c) || c == '_') {
+    if (isalpha(static_cast<unsigned char>(c)) || c == '_') {
         token = scanIdentifier();
-    } else if (isdigit(c)) {
+    } else if (isDigitChar(c)) {
         token = scanNumber();
     } else if (c == '"' || c == '\'') {
         token = scanString();
     } else if (c == '/' && peek(1) == '^') {
         // Single-line comment
-        advance(); // Skip '/'
-        advance(); // Skip '^'
-        std::string content;
-        while (!isAtEnd() && peek() != '\n') {
-            content += advance();
-        }
+        int startLine = currentLine;
+        int startColumn = currentColumn;
+        consume(2); // Skip "/^"
+        size_t length = 0;
+        while (peek(length) != '\0' && peek(length) != '\n') length++;
+        std::string content = slice(length);
+        consume(length);
         if (!isAtEnd()) {
             advance(); // Skip the newline
         }
-        return Token(TokenType::SINGLE_COMMENT_START, content, currentLine, currentColumn);
+        return Token(TokenType::SINGLE_COMMENT_START, content, startLine, startColumn);
     } else if (c == '/' && peek(1) == '@') {
         // Multi-line comment start
         advance(); // Skip '/'
@@ -92,13 +155,13 @@ Token Scanner::getNextToken() {
     } else if (c == '#') {
         std::string include;
         advance(); // Skip '#'
-        while (!isAtEnd() && !isspace(peek())) {
+        while (!isAtEnd() && !isspace(static_cast<unsigned char>(peek()))) {
             include += advance();
         }
         if (include == "include") {
             skipWhitespace();
             std::string filename;
-            while (!isAtEnd() && !isspace(peek())) {
+            while (!isAtEnd() && !isspace(static_cast<unsigned char>(peek()))) {
                 filename += advance();
             }
             handleInclude(filename);
@@ -114,12 +177,12 @@ Token Scanner::getNextToken() {
 }
 
 Token Scanner::scanIdentifier() {
-    std::string value;
     int startColumn = currentColumn;
     
-    while (!isAtEnd() && (isalnum(peek()) || peek() == '_')) {
-        value += advance();
-    }
+    size_t length = 0;
+    while (isIdentChar(peek(length))) length++;
+    std::string value = slice(length);
+    consume(length);
     
     // Check if it's a type keyword
     if (value == "int" || value == "float" || value == "string" || value == "bool") {
@@ -128,14 +191,14 @@ Token Scanner::scanIdentifier() {
     
     // Check if it's a register (reg followed by number)
     if (value == "reg") {
-        if (!isAtEnd() && isdigit(peek())) {
+        if (isDigitChar(peek())) {
             value += advance(); // Add the number to the register name
             return Token(TokenType::REG, value, currentLine, startColumn);
         }
     }
     
     // Check if identifier starts with a number
-    if (isdigit(value[0])) {
+    if (isDigitChar(value[0])) {
         return errorToken("Invalid identifier: " + value);
     }
     
@@ -144,38 +207,35 @@ Token Scanner::scanIdentifier() {
         return Token(TokenType::BOOL_LITERAL, value, currentLine, startColumn);
     }
     
-    auto it = keywords.find(value);
-    if (it != keywords.end()) {
-        return Token(it->second, value, currentLine, startColumn);
-    }
-    
-    return Token(TokenType::IDENTIFIER, value, currentLine, startColumn);
+    return Token(lookupKeyword(value), value, currentLine, startColumn);
 }
 
 Token Scanner::scanNumber() {
-    std::string value;
     int startColumn = currentColumn;
     bool isFloat = false;
     
-    while (!isAtEnd() && (isdigit(peek()) || peek() == '.')) {
-        if (peek() == '.') {
+    size_t length = 0;
+    for (char c = peek(); isDigitChar(c) || c == '.'; c = peek(++length)) {
+        if (c == '.') {
             if (isFloat) {
+                consume(length);
                 return errorToken("Invalid number format");
             }
             isFloat = true;
         }
-        value += advance();
     }
     
     // If the number is followed by an identifier, it's an invalid identifier
-    if (!isAtEnd() && (isalpha(peek()) || peek() == '_')) {
-        std::string identifier = value;
-        while (!isAtEnd() && (isalnum(peek()) || peek() == '_')) {
-            identifier += advance();
-        }
+    char next = peek(length);
+    if (isalpha(static_cast<unsigned char>(next)) || next == '_') {
+        while (isIdentChar(peek(length))) length++;
+        std::string identifier = slice(length);
+        consume(length);
         return errorToken("Invalid identifier: " + identifier);
     }
     
+    std::string value = slice(length);
+    consume(length);
     return Token(isFloat ? TokenType::FLOAT_LITERAL : TokenType::INTEGER_LITERAL,
                 value, currentLine, startColumn);
 }
@@ -185,34 +245,38 @@ Token Scanner::scanString() {
     int startColumn = currentColumn;
     char quote = advance(); // Skip opening quote
     
-    try {
-        while (!isAtEnd()) {
-            char c = peek();
-            if (c == quote) {
-                advance(); // Skip closing quote
-                return Token(TokenType::STRING_LITERAL, value, currentLine, startColumn);
-            } else if (c == '\\') {
-                advance(); // Skip backslash
-                if (isAtEnd()) {
-                    return errorToken("Unterminated string after escape character");
-                }
-                switch (peek()) {
-                    case 'n': value.push_back('\n'); break;
-                    case 't': value.push_back('\t'); break;
-                    case '\\': value.push_back('\\'); break;
-                    case '"': value.push_back('"'); break;
-                    case '\'': value.push_back('\''); break;
-                    default: value.push_back('\\'); value.push_back(peek()); break;
-                }
-                advance();
-            } else if (c == '\n') {
-                return errorToken("Unterminated string - newline in string literal");
-            } else {
-                value.push_back(advance());
+    while (!isAtEnd()) {
+        // Copy the run of plain characters in one slice
+        size_t run = 0;
+        for (char c = peek(); c != '\0' && c != quote && c != '\\' && c != '\n'; c = peek(++run)) {}
+        value += slice(run);
+        consume(run);
+        if (isAtEnd()) break;
+        
+        char c = peek();
+        if (c == quote) {
+            advance(); // Skip closing quote
+            return Token(TokenType::STRING_LITERAL, value, currentLine, startColumn);
+        } else if (c == '\\') {
+            advance(); // Skip backslash
+            if (isAtEnd()) {
+                return errorToken("Unterminated string after escape character");
+            }
+            switch (peek()) {
+                case 'n': value.push_back('\n'); break;
+                case 't': value.push_back('\t'); break;
+                case '\\': value.push_back('\\'); break;
+                case '"': value.push_back('"'); break;
+                case '\'': value.push_back('\''); break;
+                default: value.push_back('\\'); value.push_back(peek()); break;
             }
+            advance();
+        } else if (c == '\n') {
+            return errorToken("Unterminated string - newline in string literal");
+        } else {
+            // Embedded NUL byte
+            value.push_back(advance());
         }
-    } catch (const std::exception& e) {
-        return errorToken("Error processing string literal");
     }
     
     return errorToken("Unterminated string");
@@ -223,10 +287,14 @@ Token Scanner::scanComment() {
     std::string content;
     
     while (!isAtEnd()) {
+        size_t run = 0;
+        for (char c = peek(); c != '\0' && !(c == '@' && peek(run + 1) == '/'); c = peek(++run)) {}
+        content += slice(run);
+        consume(run);
         if (peek() == '@' && peek(1) == '/') {
             return Token(TokenType::COMMENT_CONTENT, content, currentLine, startColumn);
         }
-        content += advance();
+        if (!isAtEnd()) content += advance();
     }
     
     return errorToken("Unterminated multi-line comment");
@@ -289,42 +357,63 @@ Token Scanner::scanOperator() {
 }
 
 void Scanner::skipWhitespace() {
-    while (!isAtEnd()) {
-        char c = peek();
-        if (isspace(c)) {
-            if (advance() == '\n') {
-                currentLine++;
-                currentColumn = 0;
-            }
-        } else {
-            break;
-        }
+    while (isspace(static_cast<unsigned char>(peek()))) {
+        consume(1);
     }
 }
 
-char Scanner::peek(int offset) {
-    if (isAtEnd()) return '\0';
+bool Scanner::fillBuffer(size_t needed) {
+    size_t available = bufferEnd - bufferPos;
+    if (available >= needed) return true;
+    if (!currentFile.is_open() || !currentFile.good()) return false;
     
-    char c = currentFile.peek();
-    if (c == EOF) return '\0';
-    return c;
+    // Move the unread tail to the front, growing for tokens longer than a block
+    if (bufferPos > 0) {
+        std::copy(buffer.begin() + bufferPos, buffer.begin() + bufferEnd, buffer.begin());
+        bufferPos = 0;
+        bufferEnd = available;
+    }
+    if (buffer.size() < needed + blockSize) {
+        buffer.resize(std::max(buffer.size() * 2, needed + blockSize));
+    }
+    
+    while (bufferEnd < needed && currentFile.good()) {
+        currentFile.read(buffer.data() + bufferEnd, buffer.size() - bufferEnd);
+        bufferEnd += static_cast<size_t>(currentFile.gcount());
+    }
+    return bufferEnd >= needed;
+}
+
+char Scanner::peek(size_t offset) {
+    if (bufferEnd - bufferPos <= offset && !fillBuffer(offset + 1)) return '\0';
+    return buffer[bufferPos + offset];
 }
 
 char Scanner::advance() {
     if (isAtEnd()) return '\0';
-    
-    char c = currentFile.get();
-    if (c == EOF) {
-        currentFile.setstate(std::ios::eofbit);
-        return '\0';
-    }
-    
-    currentColumn++;
+    char c = buffer[bufferPos];
+    consume(1);
     return c;
 }
 
+void Scanner::consume(size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (buffer[bufferPos + i] == '\n') {
+            currentLine++;
+            currentColumn = 0;
+        } else {
+            currentColumn++;
+        }
+    }
+    bufferPos += count;
+}
+
+std::string Scanner::slice(size_t count) const {
+    return std::string(buffer.data() + bufferPos, count);
+}
+
 bool Scanner::isAtEnd() {
-    return currentFile.eof() || !currentFile.good();
+    return bufferPos >= bufferEnd && !fillBuffer(1);
 }
 
 void Scanner::handleInclude(const std::string& filename) {
@@ -348,12 +437,17 @@ void Scanner::handleInclude(const std::string& filename) {
     std::string oldFilename = currentFilename;
     int oldLine = currentLine;
     int oldColumn = currentColumn;
+    std::vector<char> oldBuffer = std::move(buffer);
+    size_t oldBufferPos = bufferPos;
+    size_t oldBufferEnd = bufferEnd;
     
     // Process include file
     currentFile = std::move(includeFile);
     currentFilename = includePath;
     currentLine = 1;
     currentColumn = 0;
+    buffer.clear();
+    bufferPos = bufferEnd = 0;
     
     // Process all tokens from include file
     while (!isAtEnd()) {
@@ -366,6 +460,9 @@ void Scanner::handleInclude(const std::string& filename) {
     currentFilename = oldFilename;
     currentLine = oldLine;
     currentColumn = oldColumn;
+    buffer = std::move(oldBuffer);
+    bufferPos = oldBufferPos;
+    bufferEnd = oldBufferEnd;
 }
 
 Token Scanner::errorToken(const std::string& message) {
@@ -375,7 +472,7 @@ Token Scanner::errorToken(const std::string& message) {
 
 void Scanner::reportError(const std::string& message) {
     std::cerr << "Error at line " << currentLine << ", column " << currentColumn 
-              << ": " << message << std::endl;
+              << ": " << message << '\n';
     errorCount++;
 }
 
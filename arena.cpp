@@ -0,0 +1,17 @@
+#include "arena.h"
+
+void* Arena::grow(size_t size, size_t align) {
+    // Blocks from new[] are aligned for any fundamental type.
+    if (align > alignof(std::max_align_t)) throw std::bad_alloc();
+    if (size > blockSize / 4) {
+        // Large requests get a block of their own, so the current block's
+        // tail is not wasted.
+        blocks.emplace_back(new char[size]);
+        allocated += size;
+        return blocks.back().get();
+    }
+    blocks.emplace_back(new char[blockSize]);
+    cursor = blocks.back().get();
+    remaining = blockSize;
+    return allocate(size, align);
+}
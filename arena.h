@@ -0,0 +1,75 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A run of objects in an Arena; views stay valid for the life of the arena.
+template <typename T>
+struct Span {
+    T* data = nullptr;
+    uint32_t count = 0;
+
+    T* begin() const { return data; }
+    T* end() const { return data + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T& operator[](size_t i) const { return data[i]; }
+};
+
+// Bump allocator for objects that live exactly as long as one compilation.
+// Memory comes from large blocks and is handed back all at once when the
+// arena is destroyed; nothing in it is ever destroyed on its own, so only
+// trivially destructible types may be put there.
+class Arena {
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "arena objects are never destroyed");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // Copies items[0, count) into the arena.
+    template <typename T>
+    Span<T> copy(const T* items, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "arena objects are never destroyed");
+        if (count == 0) return {};
+        T* data = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        std::memcpy(static_cast<void*>(data), items, sizeof(T) * count);
+        return {data, static_cast<uint32_t>(count)};
+    }
+
+    void* allocate(size_t size, size_t align) {
+        size_t padding = static_cast<size_t>(-reinterpret_cast<uintptr_t>(cursor)) & (align - 1);
+        if (padding + size > remaining) return grow(size, align);
+        char* p = cursor + padding;
+        cursor = p + size;
+        remaining -= padding + size;
+        allocated += size;
+        return p;
+    }
+
+    // Bytes handed out so far, not counting padding and unused block tails.
+    size_t bytesAllocated() const { return allocated; }
+
+private:
+    void* grow(size_t size, size_t align);
+
+    static constexpr size_t blockSize = 64 * 1024;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    size_t remaining = 0;
+    size_t allocated = 0;
+};
+
+#endif
@@ -0,0 +1,207 @@
+#ifndef AST_H
+#define AST_H
+
+#include "arena.h"
+#include "interner.h"
+#include "source_loc.h"
+#include "symbol_table.h"
+#include "token.h"
+
+// Syntax tree built by Parser. Every node lives in the compilation's Arena
+// and is trivially destructible: children are plain pointers and Spans
+// into the same arena, names are interned Symbols, and constants are
+// indices into the scanner's LiteralTable, so the whole tree goes away
+// with the arena. A null child marks a part that failed to parse.
+
+enum class NodeKind : unsigned char {
+    // Declarations and statements
+    Program,
+    VarDecl,
+    FunDecl,
+    Block,
+    If,
+    Loop,
+    Return,
+    Break,
+    ExprStmt,
+    Assign,
+    Empty,
+    // Expressions
+    Binary,
+    Unary,
+    Name,
+    Literal,
+};
+
+struct Node {
+    NodeKind kind;
+    SourceLoc loc; // first token of the construct
+
+    Node(NodeKind kind, SourceLoc loc) : kind(kind), loc(loc) {}
+};
+
+// `node` as a T, or nullptr if it is some other kind (or null).
+template <typename T>
+T* nodeAs(Node* node) {
+    return node && node->kind == T::Kind ? static_cast<T*>(node) : nullptr;
+}
+template <typename T>
+const T* nodeAs(const Node* node) {
+    return node && node->kind == T::Kind ? static_cast<const T*>(node) : nullptr;
+}
+
+// Expressions
+
+struct Expr : Node {
+    using Node::Node;
+};
+
+// `left op right`; op is an arithmetic, comparison, And or Or token type.
+struct BinaryExpr : Expr {
+    static constexpr NodeKind Kind = NodeKind::Binary;
+    TokenType op;
+    Expr* left;
+    Expr* right;
+
+    BinaryExpr(SourceLoc loc, TokenType op, Expr* left, Expr* right)
+        : Expr(Kind, loc), op(op), left(left), right(right) {}
+};
+
+// `op operand`; op is Minus or Not.
+struct UnaryExpr : Expr {
+    static constexpr NodeKind Kind = NodeKind::Unary;
+    TokenType op;
+    Expr* operand;
+
+    UnaryExpr(SourceLoc loc, TokenType op, Expr* operand) : Expr(Kind, loc), op(op), operand(operand) {}
+};
+
+struct NameExpr : Expr {
+    static constexpr NodeKind Kind = NodeKind::Name;
+    Symbol name;
+
+    NameExpr(SourceLoc loc, Symbol name) : Expr(Kind, loc), name(name) {}
+};
+
+// A constant; `type` is its token type and `literal` its index in the
+// scanner's LiteralTable (see Scanner::integerValue() and friends).
+struct LiteralExpr : Expr {
+    static constexpr NodeKind Kind = NodeKind::Literal;
+    TokenType type;
+    uint32_t literal;
+
+    LiteralExpr(SourceLoc loc, TokenType type, uint32_t literal) : Expr(Kind, loc), type(type), literal(literal) {}
+};
+
+// Declarations
+
+struct Declarator {
+    Symbol name;
+    SourceLoc loc;
+    Expr* init; // null without an initializer
+};
+
+// `Imw a = 1, b;`
+struct VarDecl : Node {
+    static constexpr NodeKind Kind = NodeKind::VarDecl;
+    SymbolType type;
+    Span<Declarator> declarators;
+
+    VarDecl(SourceLoc loc, SymbolType type, Span<Declarator> declarators)
+        : Node(Kind, loc), type(type), declarators(declarators) {}
+};
+
+struct Param {
+    SymbolType type;
+    Symbol name;
+    SourceLoc loc;
+};
+
+struct FunDecl : Node {
+    static constexpr NodeKind Kind = NodeKind::FunDecl;
+    SymbolType returnType;
+    Symbol name;
+    Span<Param> params;
+    Span<Node*> body;
+
+    FunDecl(SourceLoc loc, SymbolType returnType, Symbol name, Span<Param> params, Span<Node*> body)
+        : Node(Kind, loc), returnType(returnType), name(name), params(params), body(body) {}
+};
+
+// Statements
+
+struct Program : Node {
+    static constexpr NodeKind Kind = NodeKind::Program;
+    Span<Node*> items;
+
+    Program(SourceLoc loc, Span<Node*> items) : Node(Kind, loc), items(items) {}
+};
+
+struct Block : Node {
+    static constexpr NodeKind Kind = NodeKind::Block;
+    Span<Node*> statements;
+
+    Block(SourceLoc loc, Span<Node*> statements) : Node(Kind, loc), statements(statements) {}
+};
+
+// `IfTrue (condition) then [Otherwise otherwise]`
+struct IfStmt : Node {
+    static constexpr NodeKind Kind = NodeKind::If;
+    Expr* condition;
+    Node* then;
+    Node* otherwise; // null without an Otherwise branch
+
+    IfStmt(SourceLoc loc, Expr* condition, Node* then, Node* otherwise)
+        : Node(Kind, loc), condition(condition), then(then), otherwise(otherwise) {}
+};
+
+// The keyword a loop was written with; both scan as TokenType::Loop.
+enum class LoopKeyword : unsigned char { RepeatWhen, Reiterate };
+
+// `RepeatWhen (condition) body` or `Reiterate (condition) body`
+struct LoopStmt : Node {
+    static constexpr NodeKind Kind = NodeKind::Loop;
+    LoopKeyword keyword;
+    Expr* condition;
+    Node* body;
+
+    LoopStmt(SourceLoc loc, LoopKeyword keyword, Expr* condition, Node* body)
+        : Node(Kind, loc), keyword(keyword), condition(condition), body(body) {}
+};
+
+struct ReturnStmt : Node {
+    static constexpr NodeKind Kind = NodeKind::Return;
+    Expr* value;
+
+    ReturnStmt(SourceLoc loc, Expr* value) : Node(Kind, loc), value(value) {}
+};
+
+struct BreakStmt : Node {
+    static constexpr NodeKind Kind = NodeKind::Break;
+
+    explicit BreakStmt(SourceLoc loc) : Node(Kind, loc) {}
+};
+
+struct ExprStmt : Node {
+    static constexpr NodeKind Kind = NodeKind::ExprStmt;
+    Expr* expr;
+
+    ExprStmt(SourceLoc loc, Expr* expr) : Node(Kind, loc), expr(expr) {}
+};
+
+// `name = value;`
+struct AssignStmt : Node {
+    static constexpr NodeKind Kind = NodeKind::Assign;
+    Symbol target;
+    Expr* value;
+
+    AssignStmt(SourceLoc loc, Symbol target, Expr* value) : Node(Kind, loc), target(target), value(value) {}
+};
+
+struct EmptyStmt : Node {
+    static constexpr NodeKind Kind = NodeKind::Empty;
+
+    explicit EmptyStmt(SourceLoc loc) : Node(Kind, loc) {}
+};
+
+#endif
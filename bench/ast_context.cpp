@@ -0,0 +1,151 @@
+// Times building and freeing HEADERS/ syntax trees in an ASTContext.
+//
+// The synthetic part builds 1M nodes (250k declarations of the form
+// x = name + 42) twice, once in a context and once with one heap allocation
+// per node, and frees both. The parse part runs the HEADERS/ parser over
+// `file`, or over a generated source written to a temporary file when none
+// is given. Each figure is the best of `runs`.
+//
+//     ast_context [file] [runs (default: 7)]
+
+#include "../HEADERS/parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration<double>(to - from).count();
+}
+
+struct Timing {
+    double build = 1e9;
+    double free = 1e9;
+
+    void add(Clock::time_point start, Clock::time_point built, Clock::time_point freed) {
+        build = std::min(build, seconds(start, built));
+        free = std::min(free, seconds(built, freed));
+    }
+};
+
+constexpr int declarations = 250000;
+
+Timing inContext(unsigned runs, const std::vector<std::string>& names) {
+    Timing timing;
+    for (unsigned run = 0; run < runs; ++run) {
+        auto start = Clock::now();
+        auto context = std::make_unique<ASTContext>();
+        std::vector<ASTNode*> statements;
+        for (int i = 0; i < declarations; ++i) {
+            const std::string& name = names[i % names.size()];
+            auto* left = context->create<IdentifierNode>(context->intern(name), i, 5);
+            auto* right = context->create<LiteralNode>(context->intern("42"), TokenType::INTEGER_LITERAL, i, 12);
+            auto* sum = context->create<BinaryExprNode>(TokenType::PLUS, left, right, i, 10);
+            statements.push_back(context->create<VariableDeclNode>(context->intern(name), TokenType::IMW, sum, i, 1));
+        }
+        auto* block = context->create<BlockNode>(0, 0);
+        block->statements = context->list(statements.data(), statements.size());
+        auto built = Clock::now();
+        context.reset();
+        timing.add(start, built, Clock::now());
+    }
+    return timing;
+}
+
+Timing onHeap(unsigned runs, const std::vector<std::string>& names) {
+    Timing timing;
+    for (unsigned run = 0; run < runs; ++run) {
+        auto start = Clock::now();
+        std::vector<std::unique_ptr<IdentifierNode>> identifiers;
+        std::vector<std::unique_ptr<LiteralNode>> literals;
+        std::vector<std::unique_ptr<BinaryExprNode>> sums;
+        std::vector<std::unique_ptr<VariableDeclNode>> statements;
+        for (int i = 0; i < declarations; ++i) {
+            const std::string& name = names[i % names.size()];
+            identifiers.push_back(std::make_unique<IdentifierNode>(name, i, 5));
+            literals.push_back(std::make_unique<LiteralNode>("42", TokenType::INTEGER_LITERAL, i, 12));
+            sums.push_back(std::make_unique<BinaryExprNode>(TokenType::PLUS, identifiers.back().get(),
+                                                            literals.back().get(), i, 10));
+            statements.push_back(std::make_unique<VariableDeclNode>(name, TokenType::IMW, sums.back().get(), i, 1));
+        }
+        auto block = std::make_unique<BlockNode>(0, 0);
+        auto built = Clock::now();
+        block.reset();
+        statements.clear();
+        sums.clear();
+        literals.clear();
+        identifiers.clear();
+        timing.add(start, built, Clock::now());
+    }
+    return timing;
+}
+
+// Functions of declarations with small expressions, about 25 bytes a node.
+void generate(const std::string& path) {
+    std::ofstream out(path);
+    for (int function = 0; function < 2000; ++function) {
+        out << "Imw f" << function << "(Imw a, Float b) {\n";
+        for (int i = 0; i < 60; ++i) {
+            out << "    Imw x" << i << " = a + b * " << i << " - (c" << i % 7 << " / 2);\n";
+        }
+        out << "    IfTrue (a < b) { Return a; } Otherwise { Return b; }\n}\n";
+    }
+}
+
+Timing parse(unsigned runs, const std::string& path) {
+    std::cout.setstate(std::ios::failbit); // the parser reports every rule it matches
+    Timing timing;
+    for (unsigned run = 0; run < runs; ++run) {
+        Scanner scanner;
+        if (!scanner.openFile(path)) {
+            std::fprintf(stderr, "cannot read %s\n", path.c_str());
+            std::exit(2);
+        }
+        auto start = Clock::now();
+        auto context = std::make_unique<ASTContext>();
+        Parser parser(scanner, *context);
+        if (!parser.parse()) std::abort();
+        auto built = Clock::now();
+        context.reset();
+        timing.add(start, built, Clock::now());
+    }
+    std::cout.clear();
+    return timing;
+}
+
+void print(const char* what, const Timing& timing) {
+    std::printf("%-22s %9.1f ms %9.2f ms\n", what, timing.build * 1e3, timing.free * 1e3);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "";
+    unsigned runs = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 7;
+    bool generated = path.empty();
+    if (generated) {
+        path = (std::filesystem::temp_directory_path() / "ast_context_bench.txt").string();
+        generate(path);
+    }
+
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; ++i) names.push_back("v" + std::to_string(i));
+
+    std::printf("%-22s %12s %12s\n", "", "build/parse", "free");
+    print("1M nodes, context", inContext(runs, names));
+    print("1M nodes, heap", onHeap(runs, names));
+    print(generated ? "parse generated source" : "parse file", parse(runs, path));
+    if (generated) std::filesystem::remove(path);
+    return 0;
+}
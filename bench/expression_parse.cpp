@@ -0,0 +1,116 @@
+// Times quiet compiles of expression-heavy sources, which spend most of
+// their parse in the binding-power loop of Parser::expression(). Two
+// sources are generated into `scratch file` in turn:
+//   - long chains: 150k assignments of 12 operands mixing all four
+//     arithmetic operators, so every operand goes through the loop;
+//   - nested: random expressions up to four parentheses deep and IfTrue
+//     conditions joining comparisons with && and ||.
+// Each figure is the best of `runs` compiles.
+//
+//     expression_parse <scratch file> [runs (default: 5)]
+
+#include "compiler.h"
+#include "report.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace {
+
+const char* const variables[] = {"a", "b", "c"};
+const char* const operands[] = {"a", "b", "c", "2", "7"};
+const char* const arithmetic[] = {" + ", " - ", " * ", " / "};
+const char* const comparisons[] = {" < ", " <= ", " > ", " >= ", " == ", " != "};
+
+template <size_t N>
+const char* pick(std::mt19937& random, const char* const (&from)[N]) {
+    return from[random() % N];
+}
+
+std::string arithmeticExpression(std::mt19937& random, int depth) {
+    std::string text;
+    int terms = 1 + random() % 8;
+    for (int i = 0; i < terms; ++i) {
+        if (i > 0) text += pick(random, arithmetic);
+        if (depth > 0 && random() % 6 == 0) {
+            text += "(" + arithmeticExpression(random, depth - 1) + ")";
+        } else {
+            text += pick(random, operands);
+        }
+    }
+    return text;
+}
+
+std::string condition(std::mt19937& random) {
+    std::string text;
+    int comparisonsJoined = 1 + random() % 3;
+    for (int i = 0; i < comparisonsJoined; ++i) {
+        if (i > 0) text += random() % 2 ? " && " : " || ";
+        text += arithmeticExpression(random, 2) + pick(random, comparisons) + arithmeticExpression(random, 2);
+    }
+    return text;
+}
+
+void writeChains(const char* path) {
+    std::mt19937 random(24);
+    std::ofstream out(path);
+    out << "Imw a = 1, b = 2, c = 3, v;\n";
+    for (int line = 0; line < 150000; ++line) {
+        // A constant right after '=' is parsed as the whole value.
+        out << "v = " << pick(random, variables);
+        for (int i = 1; i < 12; ++i) out << pick(random, arithmetic) << pick(random, operands);
+        out << ";\n";
+    }
+}
+
+void writeNested(const char* path) {
+    std::mt19937 random(24);
+    std::ofstream out(path);
+    out << "Imw a = 1, b = 2, c = 3, v;\n";
+    for (int line = 0; line < 80000; ++line) {
+        if (random() % 3 == 0) {
+            out << "IfTrue (" << condition(random) << ") { v = 1; } Otherwise { v = 2; }\n";
+        } else {
+            out << "v = a + " << arithmeticExpression(random, 4) << ";\n";
+        }
+    }
+}
+
+double bestSeconds(const char* path, unsigned runs) {
+    double best = 1e9;
+    for (unsigned run = 0; run < runs; ++run) {
+        Report report(Verbosity::Quiet);
+        Compiler compiler(report);
+        auto start = std::chrono::steady_clock::now();
+        if (!compiler.compile(path)) {
+            std::fprintf(stderr, "cannot compile %s\n", path);
+            std::exit(1);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: expression_parse <scratch file> [runs]\n");
+        return 2;
+    }
+    const char* path = argv[1];
+    unsigned runs = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 5;
+
+    writeChains(path);
+    std::printf("long chains  %8.3f s\n", bestSeconds(path, runs));
+    writeNested(path);
+    std::printf("nested       %8.3f s\n", bestSeconds(path, runs));
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,174 @@
+// Times walking a HEADERS/ syntax tree through its pointers against a scan
+// of the same tree flattened into a FlatAST, and the conversion itself.
+// Both walks sum the lines of binary expressions and count identifiers;
+// the sums are checked to agree. The tree is parsed from `file`, or from a
+// generated source of about 1.5M nodes written to a temporary file when
+// none is given. Each figure is the best of `runs`.
+//
+//     flat_ast_walk [file] [runs (default: 9)]
+
+#include "../HEADERS/flat_ast.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Totals {
+    uint64_t binaryLines = 0;
+    uint64_t identifiers = 0;
+
+    bool operator==(const Totals& other) const {
+        return binaryLines == other.binaryLines && identifiers == other.identifiers;
+    }
+};
+
+void walk(const ASTNode* node, Totals& totals) {
+    if (!node) return;
+    switch (node->type) {
+        case NodeType::BLOCK:
+            for (const ASTNode* statement : static_cast<const BlockNode*>(node)->statements) walk(statement, totals);
+            break;
+        case NodeType::FUNCTION_DECL:
+            walk(static_cast<const FunctionDeclNode*>(node)->body, totals);
+            break;
+        case NodeType::NORETURN_FUNC:
+            walk(static_cast<const NOReturnFuncNode*>(node)->body, totals);
+            break;
+        case NodeType::VARIABLE_DECL:
+            walk(static_cast<const VariableDeclNode*>(node)->initializer, totals);
+            break;
+        case NodeType::IF_STMT: {
+            auto stmt = static_cast<const IfStmtNode*>(node);
+            walk(stmt->condition, totals);
+            walk(stmt->thenBranch, totals);
+            walk(stmt->elseBranch, totals);
+            break;
+        }
+        case NodeType::WHILE_STMT: {
+            auto stmt = static_cast<const WhileStmtNode*>(node);
+            walk(stmt->condition, totals);
+            walk(stmt->body, totals);
+            break;
+        }
+        case NodeType::REPEATWHEN_STMT: {
+            auto stmt = static_cast<const RepeatWhenStmtNode*>(node);
+            walk(stmt->condition, totals);
+            walk(stmt->body, totals);
+            break;
+        }
+        case NodeType::FOR_STMT: {
+            auto stmt = static_cast<const ForStmtNode*>(node);
+            walk(stmt->initializer, totals);
+            walk(stmt->condition, totals);
+            walk(stmt->increment, totals);
+            walk(stmt->body, totals);
+            break;
+        }
+        case NodeType::RETURN_STMT:
+            walk(static_cast<const ReturnStmtNode*>(node)->value, totals);
+            break;
+        case NodeType::BINARY_EXPR: {
+            auto expr = static_cast<const BinaryExprNode*>(node);
+            totals.binaryLines += node->line;
+            walk(expr->left, totals);
+            walk(expr->right, totals);
+            break;
+        }
+        case NodeType::UNARY_EXPR:
+            walk(static_cast<const UnaryExprNode*>(node)->expr, totals);
+            break;
+        case NodeType::IDENTIFIER:
+            totals.identifiers++;
+            break;
+        default:
+            break;
+    }
+}
+
+Totals scan(const FlatAST& flat) {
+    Totals totals;
+    for (NodeIndex i : flat.nodes()) {
+        NodeType type = flat.type(i);
+        if (type == NodeType::BINARY_EXPR) totals.binaryLines += flat.line(i);
+        totals.identifiers += type == NodeType::IDENTIFIER;
+    }
+    return totals;
+}
+
+// Functions of declarations, conditions and loops over small expressions.
+void generate(const std::string& path) {
+    std::ofstream out(path);
+    for (int function = 0; function < 2000; ++function) {
+        out << "Imw f" << function << "(Imw a, Float b) {\n";
+        for (int i = 0; i < 50; ++i) {
+            out << "    Imw x" << i << " = a + b * " << i << " - (c" << i % 7 << " / -a);\n";
+        }
+        out << "    IfTrue (a < b) { Return a; } Otherwise { Return b; }\n"
+            << "    While (a > 0) { a = a - 1; }\n}\n";
+    }
+}
+
+template <typename Run>
+double bestSeconds(unsigned runs, Run run) {
+    double best = 1e9;
+    for (unsigned i = 0; i < runs; ++i) {
+        auto start = Clock::now();
+        run();
+        best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "";
+    unsigned runs = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 9;
+    bool generated = path.empty();
+    if (generated) {
+        path = (std::filesystem::temp_directory_path() / "flat_ast_walk_bench.txt").string();
+        generate(path);
+    }
+
+    Scanner scanner;
+    if (!scanner.openFile(path)) {
+        std::fprintf(stderr, "cannot read %s\n", path.c_str());
+        return 2;
+    }
+    ASTContext context;
+    Parser parser(scanner, context);
+    std::cout.setstate(std::ios::failbit); // the parser reports every rule it matches
+    const ASTNode* root = parser.parse();
+    std::cout.clear();
+    if (generated) std::filesystem::remove(path);
+
+    FlatAST flat;
+    double convert = bestSeconds(runs, [&] { flat = FlatAST(root); });
+    Totals pointerTotals;
+    Totals flatTotals;
+    double pointers = bestSeconds(runs, [&] {
+        pointerTotals = Totals();
+        walk(root, pointerTotals);
+    });
+    double columns = bestSeconds(runs, [&] { flatTotals = scan(flat); });
+    if (!(pointerTotals == flatTotals)) {
+        std::fprintf(stderr, "the walks disagree\n");
+        return 1;
+    }
+
+    std::printf("%zu nodes\n", flat.size());
+    std::printf("convert        %8.2f ms\n", convert * 1e3);
+    std::printf("pointer walk   %8.2f ms\n", pointers * 1e3);
+    std::printf("flat scan      %8.2f ms\n", columns * 1e3);
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Times the HEADERS/ parser on a generated source of random expressions,
+// which it parses in the binding-power loop of Parser::parseExpression():
+// functions of declarations whose values mix every binary operator, prefix
+// - and !, and parentheses. The source is written to `scratch file`. Each
+// figure is the best of `runs` parses.
+//
+//     front_end_expressions <scratch file> [runs (default: 5)]
+
+#include "../HEADERS/parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+
+const char* const operands[] = {"a", "b", "c", "1", "2", "3.5"};
+const char* const operators[] = {" + ", " - ", " * ", " / ", " < ", " <= ", " > ",
+                                 " >= ", " == ", " != ", " && ", " || "};
+
+template <size_t N>
+const char* pick(std::mt19937& random, const char* const (&from)[N]) {
+    return from[random() % N];
+}
+
+std::string expression(std::mt19937& random, int depth) {
+    std::string text;
+    int terms = 1 + random() % 10;
+    for (int i = 0; i < terms; ++i) {
+        if (i > 0) text += pick(random, operators);
+        switch (random() % 8) {
+            case 0: text += "-"; break;
+            case 1: text += "!"; break;
+            default: break;
+        }
+        if (depth > 0 && random() % 6 == 0) {
+            text += "(" + expression(random, depth - 1) + ")";
+        } else {
+            text += pick(random, operands);
+        }
+    }
+    return text;
+}
+
+void generate(const char* path) {
+    std::mt19937 random(24);
+    std::ofstream out(path);
+    for (int function = 0; function < 3000; ++function) {
+        out << "Imw f" << function << "(Imw a, Imw b) {\n";
+        for (int i = 0; i < 20; ++i) out << "    Imw x" << i << " = " << expression(random, 3) << ";\n";
+        out << "    Return " << expression(random, 3) << ";\n}\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: front_end_expressions <scratch file> [runs]\n");
+        return 2;
+    }
+    const char* path = argv[1];
+    unsigned runs = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 5;
+    generate(path);
+
+    std::cout.setstate(std::ios::failbit); // the parser reports every rule it matches
+    double best = 1e9;
+    int errors = 0;
+    for (unsigned run = 0; run < runs; ++run) {
+        Scanner scanner;
+        if (!scanner.openFile(path)) {
+            std::fprintf(stderr, "cannot read %s\n", path);
+            return 2;
+        }
+        ASTContext context;
+        Parser parser(scanner, context);
+        auto start = std::chrono::steady_clock::now();
+        if (!parser.parse()) std::abort();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+        errors = parser.getErrorCount();
+    }
+    std::printf("%.1f MB: parse %.3f s, %d errors\n", std::filesystem::file_size(path) / (1024.0 * 1024.0), best,
+                errors);
+    std::remove(path);
+    return 0;
+}
@@ -0,0 +1,58 @@
+// Times Scanner::scanTokensParallel() against scanTokens() on one file for
+// every thread count from 1 to N. Each figure is the best of `runs` scans.
+//
+//     scan_scaling <file> [max threads (default: cores)] [runs (default: 5)]
+
+#include "scanner.h"
+#include "source_buffer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+
+template <typename Scan>
+double bestSeconds(unsigned runs, Scan scan) {
+    double best = 1e9;
+    for (unsigned run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        size_t tokens = scan();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (tokens == 0) std::abort(); // keeps the scan from being optimized out
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: scan_scaling <file> [max threads] [runs]\n");
+        return 2;
+    }
+    SourceBuffer source;
+    if (!source.load(argv[1])) {
+        std::fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 2;
+    }
+    unsigned maxThreads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2]))
+                                   : std::max(1u, std::thread::hardware_concurrency());
+    unsigned runs = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 5;
+
+    double sequential = bestSeconds(runs, [&] { return Scanner<KeepTrivia>(source.view()).scanTokens().size(); });
+    double megabytes = source.size() / (1024.0 * 1024.0);
+    std::printf("%s: %.1f MB, %u cores\n", argv[1], megabytes, std::thread::hardware_concurrency());
+    std::printf("threads   seconds    MB/s   speedup\n");
+    std::printf("    seq  %8.3f  %6.0f     1.00\n", sequential, megabytes / sequential);
+    for (unsigned threads = 1; threads <= maxThreads; ++threads) {
+        double seconds = bestSeconds(runs, [&] {
+            return Scanner<KeepTrivia>(source.view()).scanTokensParallel(threads).size();
+        });
+        std::printf("%7u  %8.3f  %6.0f  %7.2f\n", threads, seconds, megabytes / seconds, sequential / seconds);
+    }
+    return 0;
+}
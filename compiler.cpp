@@ -1,119 +1,140 @@
 #include "compiler.h"
+#include "arena.h"
+#include "interner.h"
 #include "scanner.h"
 #include "symbol_table.h"
 #include "token.h"
 #include "parser.h"
 
 #include <iostream>
-#include <sstream>
-#include <fstream>
-
-SymbolType mapTokenTypeToSymbolType(TokenType tokenType) {
-    switch (tokenType) {
-        case TokenType::Integer: return SymbolType::Integer;
-        case TokenType::SInteger: return SymbolType::SInteger;
-        case TokenType::Character: return SymbolType::Character;
-        case TokenType::String: return SymbolType::String;
-        case TokenType::Float: return SymbolType::Float;
-        case TokenType::SFloat: return SymbolType::SFloat;
-        case TokenType::Void: return SymbolType::Void;
-        default: return SymbolType::Unknown;
+#include <vector>
+
+Compiler::Compiler(Report& report, EventWriter* events, size_t errorLimit)
+    : report(report), events(events), errorLimit(errorLimit) {}
+
+void Compiler::printTokens(const TokenBuffer& tokens, const LineTable& lines) const {
+    // Display tokens
+    if (report.shows(Verbosity::Tokens)) {
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            report << "Line: " << lines.line(tokens.endLoc(i))
+                   << " Token Text: " << tokens.lexeme(i)
+                   << " Token Type: " << tokenTypeToString(tokens.type(i))
+                   << '\n';
+        }
     }
+    if (events && events->emitsTokens()) events->tokens(tokens, lines);
 }
 
-void handleDeclarations(const vector<Token>& tokens, SymbolTable& symtab) {
-    for (size_t i = 0; i < tokens.size(); ++i) {
-        const Token& tok = tokens[i];
-
-        // If we see type-specifier
-        if (tok.type == TokenType::Integer || tok.type == TokenType::SInteger ||
-            tok.type == TokenType::Character || tok.type == TokenType::String ||
-            tok.type == TokenType::Float || tok.type == TokenType::SFloat ||
-            tok.type == TokenType::Void) {
-
-            SymbolType varType = mapTokenTypeToSymbolType(tok.type);
-            i++; // move to next token
-
-            // Collect identifiers
-            while (i < tokens.size() && tokens[i].type == TokenType::Identifier) {
-                string varName = tokens[i].lexeme;
-
-                // Check redeclaration
-                if (!symtab.declareVariable(varName, varType)) {
-                    cerr << "❌ Error: Variable '" << varName
-                              << "' already declared (line " << tokens[i].line << ")\n";
-                }
-
-                i++;
-                if (i < tokens.size() && tokens[i].type == TokenType::Comma) {
-                    i++; // skip comma and continue
-                } else {
-                    break; // no more IDs
-                }
-            }
+void Compiler::parse(std::string_view name, std::string_view source, const std::string& directory,
+                     const LineTable& lines) {
+    // Nothing from an earlier compile points into replaced includes any more.
+    includes.releaseSuperseded();
+    Diagnostics diagnostics(source, lines, &includes, errorLimit);
+
+    // The parser pulls tokens from its own scanner as it goes; comments are
+    // dropped there, Include directives are replaced by the cached tokens of
+    // the file they name, and identifiers arrive interned, so name lookups
+    // compare Symbols. The scanner's errors reach `diagnostics` through the
+    // parser, so the source is lexed once.
+    StringInterner names;
+    SymbolTable symtab(names);
+    Scanner<SkipTrivia> stream(source, &names);
+    stream.expandIncludes(includes, directory);
+    // The tree is freed in one go with the arena when this compile is
+    // done. Nothing walks it yet; later phases take it from here.
+    Arena arena;
+    Parser parser(stream, symtab, lines, report, diagnostics, arena, &includes, parseEvents());
+    parser.parseProgram();
+    diagnostics.add(stream.getIncludeErrors());
+
+    if (report.shows(Verbosity::Rules)) report << '\n';
+    diagnostics.render(report, parseEvents());
+
+    size_t scannerCount = diagnostics.errorCount(DiagStage::Scanner);
+    size_t includeCount = diagnostics.errorCount(DiagStage::Include);
+    size_t parserCount = diagnostics.errorCount(DiagStage::Parser) + diagnostics.errorCount(DiagStage::Semantic);
+    if (report.shows(Verbosity::Rules)) {
+        if (scannerCount > 0) report << "\nTotal scanner errors: " << scannerCount << '\n';
+        report << "\nTotal parser errors: " << parserCount << '\n';
+        report << "\n--- Compilation Complete ---\n";
+    }
+
+    // One-line summary
+    if (report.shows(Verbosity::Errors)) {
+        size_t total = diagnostics.errorCount();
+        report << name << ": ";
+        if (total == 0) {
+            report << "no errors\n";
+        } else {
+            report << total << (total == 1 ? " error" : " errors")
+                   << " (" << scannerCount << " scanner, " << parserCount << " parser";
+            if (includeCount > 0) report << ", " << includeCount << " include";
+            report << (diagnostics.limitReached() ? "; stopped at the error limit)\n" : ")\n");
         }
     }
+    report.flush();
+    if (events) events->flush();
 }
 
-std::string Compiler::readFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
-        return "";
+SourceBuffer Compiler::readFile(const std::string& filename) {
+    SourceBuffer buffer;
+    if (!buffer.load(filename) && report.shows(Verbosity::Errors)) {
+        report << "Error: Could not open file " << filename << '\n';
     }
-    
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
+    return buffer;
 }
 
-bool Compiler::compile(const std::string& sourceFile) {
-    std::string source = readFile(sourceFile);
-    if (source.empty()) {
-        return false;
+bool Compiler::fitsOffsets(std::string_view name, size_t size) {
+    // Locations are 32-bit offsets, and those from IncludeCache::firstBase
+    // up belong to included files; a larger main source would have its
+    // errors blamed on them, or its offsets wrap.
+    if (size < IncludeCache::firstBase) return true;
+    if (report.shows(Verbosity::Errors)) {
+        report << "Error: " << name << " is too large (" << size << " bytes; sources must be under "
+               << IncludeCache::firstBase << " bytes)\n";
+        report.flush();
     }
-    
-    std::cout << "--- Compiling file: " << sourceFile << " ---\n";
-    std::cout << "\n--- Source Code ---\n";
-    std::cout << source << "\n";
-    
-    // Run Scanner
-    Scanner scanner(source);
-    auto tokens = scanner.scanTokens();
+    return false;
+}
 
-    std::cout << "\n--- Scanner Output ---\n";
-    
-    // Display scanner errors as part of the scanner output
-    const auto& scannerErrors = scanner.getErrors();
-    for (const auto& error : scannerErrors) {
-        std::cout << "Scanner Error at line " << error.line << ": " << error.message << "\n";
-    }
-    
-    // Display tokens
-    for (const auto& token : tokens) {
-        std::cout << "Line: " << token.line
-                  << " Token Text: " << token.lexeme
-                  << " Token Type: " << tokenTypeToString(token.type)
-                  << "\n";
+bool Compiler::compile(const std::string& sourceFile) {
+    SourceBuffer source = readFile(sourceFile);
+    if (source.empty() || !fitsOffsets(sourceFile, source.size())) {
+        return false;
     }
     
-    // Output scanner error count at the end of scanner output
-    if (scanner.getErrorCount() > 0) {
-        std::cout << "\nTotal scanner errors: " << scanner.getErrorCount() << "\n";
+    if (report.shows(Verbosity::Rules)) report << "--- Compiling file: " << sourceFile << " ---\n";
+    if (report.shows(Verbosity::Source)) {
+        report << "\n--- Source Code ---\n" << source.view() << '\n';
     }
-
-    SymbolTable symtab;
-    Parser parser(tokens, symtab);
-    parser.parseProgram();
     
-    std::cout << "\n--- Compilation Complete ---\n";
+    // Line numbers are only worked out for what gets printed
+    LineTable lines(source.view());
+    if (events) events->file(sourceFile);
+
+    // The token listing needs the whole stream at once, so a buffer is
+    // scanned only when it is printed or emitted, and it is gone before
+    // parsing starts: the parser keeps O(1) tokens in memory.
+    if (report.shows(Verbosity::Rules)) report << "\n--- Scanner Output ---\n";
+    if (listsTokens()) printTokens(Scanner<KeepTrivia>(source.view()).scanTokens(), lines);
+
+    size_t lastSlash = sourceFile.find_last_of("/\\");
+    parse(sourceFile, source.view(), lastSlash == std::string::npos ? "" : sourceFile.substr(0, lastSlash), lines);
     return true;
 }
 
 void Compiler::run() {
     std::cout << "Enter your Project#3 code (type 'end' alone to finish input):\n";
 
-    std::ostringstream buffer;
+    // When a token listing is wanted, each line is lexed as it is typed: an
+    // append is an edit at the end of the source, so only the tail is
+    // re-scanned. The buffer serves that listing and nothing else; the
+    // parse at the end streams the whole input through its own scanner,
+    // which also reports the scanner errors.
+    bool listing = listsTokens();
+    std::string source;
+    TokenBuffer tokens = Scanner<KeepTrivia>(source).scanTokens();
+    std::vector<Diagnostic> relexErrors; // kept in step for relex(); never printed
     std::string line;
 
     while (true) {
@@ -135,39 +156,20 @@ void Compiler::run() {
             continue;
         }
         
-        buffer << line << '\n';
+        size_t end = source.size();
+        source += line;
+        source += '\n';
+        if (listing) {
+            Scanner<KeepTrivia>::relex(tokens, relexErrors, source, {end, 0, std::string_view(source).substr(end)});
+        }
     }
 
     // If there's any input in the buffer, process it
-    std::string source = buffer.str();
-    if (!source.empty()) {
-        // Run Scanner
-        Scanner scanner(source);
-        auto tokens = scanner.scanTokens();
-
-        std::cout << "\n--- Scanner Output ---\n";
-        
-        // Display scanner errors as part of the scanner output
-        const auto& scannerErrors = scanner.getErrors();
-        for (const auto& error : scannerErrors) {
-            std::cout << "Scanner Error at line " << error.line << ": " << error.message << "\n";
-        }
-        
-        // Display tokens
-        for (const auto& token : tokens) {
-            std::cout << "Line: " << token.line
-                    << " Token Text: " << token.lexeme
-                    << " Token Type: " << tokenTypeToString(token.type)
-                    << "\n";
-        }
-        
-        // Output scanner error count at the end of scanner output
-        if (scanner.getErrorCount() > 0) {
-            std::cout << "\nTotal scanner errors: " << scanner.getErrorCount() << "\n";
-        }
-
-        SymbolTable symtab;
-        Parser parser(tokens, symtab);
-        parser.parseProgram();
+    if (!source.empty() && fitsOffsets("input", source.size())) {
+        LineTable lines(source);
+        if (events) events->file("input");
+        if (report.shows(Verbosity::Rules)) report << "\n--- Scanner Output ---\n";
+        if (listing) printTokens(tokens, lines);
+        parse("input", source, "", lines);
     }
 }
@@ -1,13 +1,46 @@
 #ifndef COMPILER_H_INCLUDED
 #define COMPILER_H_INCLUDED
 #include <string>
+#include <string_view>
+#include <vector>
+#include "diagnostics.h"
+#include "emit.h"
+#include "include_cache.h"
+#include "report.h"
+#include "source_buffer.h"
 
 class Compiler {
 public:
+    // Everything the compiler prints goes through `report`; `events`, when
+    // given, gets the machine-readable dumps asked for with --emit. Each
+    // compile stops after `errorLimit` errors (0: no limit).
+    explicit Compiler(Report& report, EventWriter* events = nullptr,
+                      size_t errorLimit = Diagnostics::defaultErrorLimit);
+
     bool compile(const std::string& sourceFile);
     void run();
 private:
-    std::string readFile(const std::string& filename);
+    SourceBuffer readFile(const std::string& filename);
+    // Whether a main source of `size` bytes can be compiled; reports it if not.
+    bool fitsOffsets(std::string_view name, size_t size);
+    void printTokens(const TokenBuffer& tokens, const LineTable& lines) const;
+    // Parses `source` (called `name` in the summary) and prints its
+    // diagnostics, scanner errors among them, then the error counts.
+    void parse(std::string_view name, std::string_view source, const std::string& directory,
+               const LineTable& lines);
+
+    // Whether a token listing is printed or emitted.
+    bool listsTokens() const { return report.shows(Verbosity::Tokens) || (events && events->emitsTokens()); }
+    // The writer for the parser, if parse events were asked for.
+    EventWriter* parseEvents() const { return events && events->emitsParseEvents() ? events : nullptr; }
+
+    Report& report;
+    EventWriter* events;
+    size_t errorLimit;
+
+    // Included files are scanned once and shared by every compile in this
+    // process.
+    IncludeCache includes;
 };
 
 
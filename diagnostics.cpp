@@ -0,0 +1,193 @@
+#include "diagnostics.h"
+#include "emit.h"
+#include "include_cache.h"
+#include "report.h"
+#include "symbol_table.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+
+// In the formats, %t stands for the quoted source text, %y for a type
+// name and %r for the quoted float constant as rounded to a double.
+struct DiagInfo {
+    DiagStage stage;
+    bool warning;
+    const char* format;
+};
+
+constexpr DiagInfo infos[] = {
+    {DiagStage::Scanner, false, "Invalid UTF-8 byte sequence"},
+    {DiagStage::Scanner, false, "Unexpected character '%t'"},
+    {DiagStage::Scanner, false, "Invalid identifier '%t' - identifiers cannot start with a digit"},
+    {DiagStage::Scanner, false, "Integer constant '%t' does not fit in 64 bits"},
+    {DiagStage::Scanner, false, "Float constant '%t' is out of range for a double"},
+    {DiagStage::Scanner, true, "Float constant '%t' has more digits than a double holds; it is rounded to %r"},
+    {DiagStage::Scanner, false, "Unterminated string constant"},
+    {DiagStage::Scanner, false, "Unterminated character constant"},
+    {DiagStage::Scanner, false, "Unknown escape sequence '%t'"},
+    {DiagStage::Scanner, false, "Character constant must hold exactly one character"},
+    {DiagStage::Scanner, false, "Unterminated multi-line comment"},
+    {DiagStage::Include, false, "Expected a quoted file name after Include"},
+    {DiagStage::Include, false, "Cannot open include file '%t'"},
+    {DiagStage::Include, false, "Cannot include '%t': no source offsets are left for it"},
+    {DiagStage::Parser, false, "Invalid type"},
+    {DiagStage::Parser, false, "Expected variable name"},
+    {DiagStage::Parser, false, "Type mismatch: Cannot assign %t to variable of type %y"},
+    {DiagStage::Parser, false, "Expected ';'"},
+    {DiagStage::Parser, false, "Invalid return type"},
+    {DiagStage::Parser, false, "Expected function name"},
+    {DiagStage::Parser, false, "Expected '(' after function name"},
+    {DiagStage::Parser, false, "Invalid parameter type"},
+    {DiagStage::Parser, false, "Expected parameter name"},
+    {DiagStage::Parser, false, "Expected ',' or ')' in parameter list"},
+    {DiagStage::Parser, false, "Function '%t' already declared"},
+    {DiagStage::Parser, false, "Expected '{' at start of function body"},
+    {DiagStage::Parser, false, "Unterminated function body"},
+    {DiagStage::Parser, false, "Expected '('"},
+    {DiagStage::Parser, false, "Expected ')'"},
+    {DiagStage::Parser, false, "Expected '(' after loop condition"},
+    {DiagStage::Parser, false, "Expected ')' after loop condition"},
+    {DiagStage::Parser, false, "Expected identifier"},
+    {DiagStage::Parser, false, "Expected '='"},
+    {DiagStage::Parser, false, "Expected expression factor"},
+    {DiagStage::Parser, false, "Expected '{'"},
+    {DiagStage::Parser, false, "Expected '}'"},
+    {DiagStage::Parser, false, "Parser stuck in infinite loop - aborting"},
+    {DiagStage::Semantic, false, "Variable '%t' already declared"},
+    {DiagStage::Semantic, true, "Type checking for complex expressions not fully implemented"},
+    {DiagStage::Semantic, false, "Variable '%t' not declared before use"},
+    {DiagStage::Semantic, false, "Undefined variable '%t'"},
+};
+static_assert(sizeof(infos) / sizeof(infos[0]) == static_cast<size_t>(DiagCode::UndefinedVariable) + 1,
+              "one entry per DiagCode, in order");
+
+constexpr const char* stageNames[] = {"Scanner", "Include", "Parser", "Semantic"};
+
+const DiagInfo& info(DiagCode code) {
+    return infos[static_cast<size_t>(code)];
+}
+
+} // namespace
+
+DiagStage diagnosticStage(DiagCode code) {
+    return info(code).stage;
+}
+
+bool isWarning(DiagCode code) {
+    return info(code).warning;
+}
+
+Diagnostics::Diagnostics(std::string_view source, const LineTable& lines, const IncludeCache* includes,
+                         size_t errorLimit)
+    : source(source), lines(lines), includes(includes), errorLimit(errorLimit) {}
+
+void Diagnostics::add(const Diagnostic& diagnostic) {
+    if (diagnostic.warning()) {
+        if (!limitReached()) records.push_back(diagnostic);
+        return;
+    }
+    LineColumn at = position(diagnostic.loc);
+    auto line = lineErrors.try_emplace(diagnostic.loc.offset - static_cast<uint32_t>(at.column - 1), none);
+    if (!line.second) {
+        // A scanner error is the likelier cause of the others on its line,
+        // so it is the one kept, whichever was recorded first.
+        size_t kept = line.first->second;
+        DiagStage stage = diagnosticStage(diagnostic.code);
+        if (kept != none && stage == DiagStage::Scanner && diagnosticStage(records[kept].code) != stage) {
+            errorsByStage[static_cast<size_t>(diagnosticStage(records[kept].code))]--;
+            errorsByStage[static_cast<size_t>(stage)]++;
+            records[kept] = diagnostic;
+        }
+        return;
+    }
+    if (errorLimit != 0 && errors >= errorLimit) {
+        dropped++;
+        return;
+    }
+    errors++;
+    errorsByStage[static_cast<size_t>(diagnosticStage(diagnostic.code))]++;
+    line.first->second = records.size();
+    records.push_back(diagnostic);
+}
+
+void Diagnostics::add(const std::vector<Diagnostic>& diagnostics) {
+    for (const Diagnostic& diagnostic : diagnostics) add(diagnostic);
+}
+
+LineColumn Diagnostics::position(SourceLoc loc) const {
+    return includes ? includes->position(loc, lines) : lines.position(loc);
+}
+
+std::string_view Diagnostics::textOf(const Diagnostic& diagnostic) const {
+    if (diagnostic.textLength == 0) return {};
+    const IncludeUnit* unit = includes ? includes->unitAt(diagnostic.text) : nullptr;
+    if (unit) return unit->source.view().substr(diagnostic.text.offset - unit->base, diagnostic.textLength);
+    return source.substr(diagnostic.text.offset, diagnostic.textLength);
+}
+
+void Diagnostics::appendMessage(std::string& out, const Diagnostic& diagnostic) const {
+    for (const char* p = info(diagnostic.code).format; *p; ++p) {
+        if (*p != '%') {
+            out += *p;
+            continue;
+        }
+        switch (*++p) {
+            case 't':
+                out += textOf(diagnostic);
+                break;
+            case 'y':
+                out += symbolTypeName(static_cast<SymbolType>(diagnostic.arg));
+                break;
+            case 'r': {
+                // The scanner already warned with this value; it is worked
+                // out again rather than stored.
+                std::string_view text = textOf(diagnostic);
+                if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+                double value = 0;
+                std::from_chars(text.data(), text.data() + text.size(), value);
+                char rounded[32];
+                out.append(rounded, std::to_chars(rounded, rounded + sizeof(rounded), value).ptr);
+                break;
+            }
+        }
+    }
+}
+
+void Diagnostics::render(Report& report, EventWriter* events) {
+    bool printing = report.shows(Verbosity::Errors);
+    if (!printing && !events) return;
+
+    std::stable_sort(records.begin(), records.end(),
+                     [](const Diagnostic& a, const Diagnostic& b) { return a.loc.offset < b.loc.offset; });
+    std::string message;
+    for (const Diagnostic& diagnostic : records) {
+        message.clear();
+        appendMessage(message, diagnostic);
+        DiagStage stage = diagnosticStage(diagnostic.code);
+        LineColumn at = position(diagnostic.loc);
+        const IncludeUnit* unit = includes ? includes->unitAt(diagnostic.loc) : nullptr;
+        std::string_view file = unit ? std::string_view(unit->path) : std::string_view();
+
+        if (printing) {
+            const char* severity = diagnostic.warning() ? "Warning" : "Error";
+            if (stage == DiagStage::Semantic) {
+                report << severity << ": " << message << " (line " << at.line << ", column " << at.column;
+                if (unit) report << " in " << file;
+                report << ")\n";
+            } else {
+                report << stageNames[static_cast<size_t>(stage)] << ' ' << severity << " at line " << at.line
+                       << ", column " << at.column;
+                if (unit) report << " in " << file;
+                report << ": " << message << '\n';
+            }
+        }
+        if (events && (stage == DiagStage::Parser || stage == DiagStage::Semantic)) {
+            events->error({at, file}, message);
+        }
+    }
+    if (printing && limitReached()) {
+        report << "Too many errors (limit " << errorLimit << "); stopping\n";
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "source_loc.h"
+
+class EventWriter;
+class IncludeCache;
+class Report;
+
+// Which part of the compiler a diagnostic comes from; it decides how the
+// diagnostic is worded and where it is counted.
+enum class DiagStage : unsigned char { Scanner, Include, Parser, Semantic };
+
+// One code per message. The wording lives in a table in diagnostics.cpp
+// and is only put together when a diagnostic is printed.
+enum class DiagCode : unsigned char {
+    // Scanner
+    InvalidUtf8,
+    UnexpectedCharacter,
+    InvalidIdentifier,
+    IntegerOutOfRange,
+    FloatOutOfRange,
+    FloatRounded,
+    UnterminatedString,
+    UnterminatedCharacter,
+    UnknownEscape,
+    CharacterLength,
+    UnterminatedComment,
+    // Include directives
+    ExpectedIncludeName,
+    IncludeNotFound,
+    IncludeSpaceExhausted,
+    // Parser
+    InvalidType,
+    ExpectedVariableName,
+    TypeMismatch,
+    ExpectedSemicolon,
+    InvalidReturnType,
+    ExpectedFunctionName,
+    ExpectedParenAfterFunctionName,
+    InvalidParameterType,
+    ExpectedParameterName,
+    ExpectedParameterSeparator,
+    FunctionRedeclared,
+    ExpectedFunctionBody,
+    UnterminatedFunctionBody,
+    ExpectedLeftParen,
+    ExpectedRightParen,
+    ExpectedLoopLeftParen,
+    ExpectedLoopRightParen,
+    ExpectedIdentifier,
+    ExpectedAssignment,
+    ExpectedFactor,
+    ExpectedLeftBrace,
+    ExpectedRightBrace,
+    ParserStuck,
+    // Semantic checks made while parsing
+    VariableRedeclared,
+    UncheckedExpression,
+    UndeclaredAssignment,
+    UndefinedVariable,
+};
+
+DiagStage diagnosticStage(DiagCode code);
+bool isWarning(DiagCode code);
+
+// A diagnostic as recorded: no text, only what is needed to word it later.
+// `text`/`textLength` pick the source text a message quotes (a lexeme, a
+// file name); `arg` is a SymbolType for type mismatches.
+struct Diagnostic {
+    DiagCode code;
+    SourceLoc loc;
+    SourceLoc text;
+    uint32_t textLength = 0;
+    uint32_t arg = 0;
+
+    bool warning() const { return isWarning(code); }
+};
+
+// Collects the diagnostics of one compile. Records stay compact until
+// render(), which sorts them by location and words only those it prints,
+// so an input with thousands of errors costs little more than a clean one.
+// Only one error per line is kept (the others are nearly always knock-on
+// errors): a scanner error if there is one, else the first. Once
+// `errorLimit` errors are kept the rest are dropped and limitReached()
+// turns true, so callers can stop early.
+class Diagnostics {
+public:
+    static constexpr size_t defaultErrorLimit = 100;
+
+    // `source` and `lines` cover the main source; `includes`, locations
+    // in included files. An `errorLimit` of 0 means no limit.
+    Diagnostics(std::string_view source, const LineTable& lines, const IncludeCache* includes = nullptr,
+                size_t errorLimit = defaultErrorLimit);
+
+    void add(const Diagnostic& diagnostic);
+    void add(const std::vector<Diagnostic>& diagnostics);
+
+    bool limitReached() const { return dropped > 0; }
+    // Errors kept, over all stages or for one; warnings are not counted.
+    size_t errorCount() const { return errors; }
+    size_t errorCount(DiagStage stage) const { return errorsByStage[static_cast<size_t>(stage)]; }
+
+    // Prints everything at the Errors level of `report`, in source order.
+    // Parser and semantic diagnostics also go to `events`, if given.
+    void render(Report& report, EventWriter* events = nullptr);
+
+private:
+    LineColumn position(SourceLoc loc) const;
+    std::string_view textOf(const Diagnostic& diagnostic) const;
+    void appendMessage(std::string& out, const Diagnostic& diagnostic) const;
+
+    std::string_view source;
+    const LineTable& lines;
+    const IncludeCache* includes;
+    size_t errorLimit;
+
+    std::vector<Diagnostic> records;
+    // The index in `records` of each line's error, by the offset the line
+    // starts at; `none` once the limit dropped it.
+    static constexpr size_t none = static_cast<size_t>(-1);
+    std::unordered_map<uint32_t, size_t> lineErrors;
+    size_t errors = 0;
+    size_t errorsByStage[4] = {};
+    size_t dropped = 0;
+};
+
+#endif
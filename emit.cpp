@@ -0,0 +1,212 @@
+#include "emit.h"
+#include "unicode.h"
+
+#include <algorithm>
+
+bool parseEmitKinds(std::string_view list, EmitOptions& options) {
+    while (!list.empty()) {
+        size_t comma = std::min(list.find(','), list.size());
+        std::string_view kind = list.substr(0, comma);
+        if (kind == "tokens") {
+            options.tokens = true;
+        } else if (kind == "parse-events") {
+            options.parseEvents = true;
+        } else {
+            return false;
+        }
+        list.remove_prefix(std::min(comma + 1, list.size()));
+    }
+    return true;
+}
+
+bool parseEmitFormat(std::string_view name, EmitFormat& format) {
+    if (name == "jsonl") {
+        format = EmitFormat::JsonLines;
+    } else if (name == "binary") {
+        format = EmitFormat::Binary;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* parseRuleName(ParseRule rule) {
+    switch (rule) {
+        case ParseRule::VarDeclaration: return "var-declaration";
+        case ParseRule::FunDeclaration: return "fun-declaration";
+        case ParseRule::EmptyStatement: return "empty-statement";
+        case ParseRule::ExpressionStatement: return "expression-statement";
+        case ParseRule::IfElseStatement: return "if-else-statement";
+        case ParseRule::IterationStatement: return "iteration-statement";
+        case ParseRule::JumpStatement: return "jump-statement";
+        case ParseRule::Assignment: return "assignment";
+        case ParseRule::LogicalOr: return "logical-or";
+        case ParseRule::LogicalAnd: return "logical-and";
+        case ParseRule::Block: return "block";
+    }
+    return "unknown";
+}
+
+namespace {
+enum RecordKind : unsigned char { FileRecord, TokenRecord, RuleRecord, ErrorRecord };
+
+// Names and messages are short; anything longer is cut to fit the u16
+// length field.
+std::string_view clip16(std::string_view text) {
+    return text.substr(0, std::min<size_t>(text.size(), UINT16_MAX));
+}
+}
+
+EventWriter::EventWriter(const EmitOptions& options, Report& out) : options(options), out(out) {
+    for (int type = 0; type <= static_cast<int>(TokenType::Invalid); ++type) {
+        typeNames.push_back(tokenTypeToString(static_cast<TokenType>(type)));
+    }
+    if (options.format == EmitFormat::Binary) {
+        // Lengths, offsets and text hold 0x0A bytes that must not become CRLF.
+        out.binary();
+        out << std::string_view("P3EV", 4);
+        u8(1);
+    }
+}
+
+void EventWriter::file(std::string_view path) {
+    if (options.format == EmitFormat::Binary) {
+        beginRecord(FileRecord, path.size());
+        out << path;
+        return;
+    }
+    out << "{\"kind\":\"file\",\"path\":";
+    jsonString(path);
+    out << "}\n";
+}
+
+void EventWriter::tokens(const TokenBuffer& tokens, const LineTable& lines) {
+    LineCursor cursor(lines);
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        LineColumn position = cursor.position(tokens.loc(i));
+        string_view text = tokens.lexeme(i);
+        if (options.format == EmitFormat::Binary) {
+            beginRecord(TokenRecord, 1 + 4 * 4 + text.size());
+            u8(static_cast<unsigned char>(tokens.type(i)));
+            u32(tokens.offset(i));
+            u32(tokens.length(i));
+            u32(position.line);
+            u32(position.column);
+            out << text;
+            continue;
+        }
+        out << "{\"kind\":\"token\",\"type\":\"" << typeNames[static_cast<size_t>(tokens.type(i))] << '"';
+        jsonNumber("line", position.line);
+        jsonNumber("column", position.column);
+        jsonNumber("offset", tokens.offset(i));
+        jsonNumber("length", tokens.length(i));
+        out << ",\"text\":";
+        jsonString(text);
+        out << "}\n";
+    }
+}
+
+void EventWriter::rule(ParseRule rule, EventPosition where, std::string_view name) {
+    if (options.format == EmitFormat::Binary) {
+        name = clip16(name);
+        beginRecord(RuleRecord, 1 + 4 + 4 + 2 + name.size() + where.file.size());
+        u8(static_cast<unsigned char>(rule));
+        u32(where.position.line);
+        u32(where.position.column);
+        u16(static_cast<uint16_t>(name.size()));
+        out << name << where.file;
+        return;
+    }
+    out << "{\"kind\":\"rule\",\"rule\":\"" << parseRuleName(rule) << '"';
+    jsonNumber("line", where.position.line);
+    jsonNumber("column", where.position.column);
+    if (!name.empty()) {
+        out << ",\"name\":";
+        jsonString(name);
+    }
+    if (!where.file.empty()) {
+        out << ",\"file\":";
+        jsonString(where.file);
+    }
+    out << "}\n";
+}
+
+void EventWriter::error(EventPosition where, std::string_view message) {
+    if (options.format == EmitFormat::Binary) {
+        std::string_view file = clip16(where.file);
+        beginRecord(ErrorRecord, 4 + 4 + 2 + file.size() + message.size());
+        u32(where.position.line);
+        u32(where.position.column);
+        u16(static_cast<uint16_t>(file.size()));
+        out << file << message;
+        return;
+    }
+    out << "{\"kind\":\"error\"";
+    jsonNumber("line", where.position.line);
+    jsonNumber("column", where.position.column);
+    if (!where.file.empty()) {
+        out << ",\"file\":";
+        jsonString(where.file);
+    }
+    out << ",\"message\":";
+    jsonString(message);
+    out << "}\n";
+}
+
+// Copies runs that need no escaping in one piece. Valid UTF-8 is passed
+// through; a byte that is not part of a valid sequence (the scanner has
+// already reported it) becomes U+FFFD, so every line stays valid JSON.
+void EventWriter::jsonString(std::string_view text) {
+    static constexpr char hex[] = "0123456789abcdef";
+    out << '"';
+    size_t run = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x80) {
+            char32_t codepoint;
+            size_t length = unicode::decodeUtf8(text.data() + i, text.data() + text.size(), codepoint);
+            if (length != 0) {
+                i += length - 1;
+                continue;
+            }
+            out << text.substr(run, i - run) << "\\ufffd";
+            run = i + 1;
+            continue;
+        }
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out << text.substr(run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default: {
+                char escape[] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+                out << std::string_view(escape, sizeof(escape));
+            }
+        }
+    }
+    out << text.substr(run) << '"';
+}
+
+void EventWriter::jsonNumber(std::string_view key, uint32_t value) {
+    out << ",\"" << key << "\":" << value;
+}
+
+void EventWriter::beginRecord(unsigned char kind, size_t payload) {
+    u32(static_cast<uint32_t>(payload + 1));
+    u8(kind);
+}
+
+void EventWriter::u16(uint16_t value) {
+    char bytes[] = {static_cast<char>(value), static_cast<char>(value >> 8)};
+    out << std::string_view(bytes, sizeof(bytes));
+}
+
+void EventWriter::u32(uint32_t value) {
+    char bytes[] = {static_cast<char>(value), static_cast<char>(value >> 8), static_cast<char>(value >> 16),
+                    static_cast<char>(value >> 24)};
+    out << std::string_view(bytes, sizeof(bytes));
+}
@@ -0,0 +1,101 @@
+#ifndef EMIT_H
+#define EMIT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "report.h"
+#include "source_loc.h"
+#include "token.h"
+#include "token_buffer.h"
+
+// Machine-readable dumps for tools, asked for with --emit=tokens,parse-events.
+//
+// JSON Lines: one object per line, with a "kind" of "file", "token", "rule"
+// or "error":
+//
+//     {"kind":"token","type":"Identifier","line":3,"column":5,"offset":41,"length":3,"text":"abc"}
+//     {"kind":"rule","rule":"var-declaration","line":3,"column":8}
+//
+// Binary: the magic bytes "P3EV" and a version byte (1), then records of a
+// little-endian u32 payload length followed by the payload, whose first byte
+// is the record kind. Integers are little-endian; `rest` runs to the end of
+// the payload.
+//
+//     file   0  path: rest
+//     token  1  type: u8 (TokenType), offset: u32, length: u32, line: u32, column: u32, text: rest
+//     rule   2  rule: u8 (ParseRule), line: u32, column: u32, nameLength: u16, name, file: rest
+//     error  3  line: u32, column: u32, fileLength: u16, file, message: rest
+//
+// "file" in rule and error records names the included file the position is
+// in, and is empty for the main source.
+enum class EmitFormat : unsigned char { JsonLines, Binary };
+
+struct EmitOptions {
+    bool tokens = false;
+    bool parseEvents = false;
+    EmitFormat format = EmitFormat::JsonLines;
+};
+
+// Parses a comma-separated list of "tokens" and "parse-events" into `options`.
+bool parseEmitKinds(std::string_view list, EmitOptions& options);
+// Parses "jsonl" or "binary".
+bool parseEmitFormat(std::string_view name, EmitFormat& format);
+
+// The grammar rules the parser reports a match for.
+enum class ParseRule : unsigned char {
+    VarDeclaration,
+    FunDeclaration,
+    EmptyStatement,
+    ExpressionStatement,
+    IfElseStatement,
+    IterationStatement,
+    JumpStatement,
+    Assignment,
+    LogicalOr,
+    LogicalAnd,
+    Block,
+};
+
+const char* parseRuleName(ParseRule rule);
+
+// Where a parse event happened: `file` is empty for the main source.
+struct EventPosition {
+    LineColumn position;
+    std::string_view file;
+};
+
+// Writes records straight from the token buffer and the parser into `out`,
+// which is used as a raw byte sink (its verbosity is not consulted). For the
+// binary format `out` is switched to binary mode before the first byte.
+class EventWriter {
+public:
+    EventWriter(const EmitOptions& options, Report& out);
+
+    bool emitsTokens() const { return options.tokens; }
+    bool emitsParseEvents() const { return options.parseEvents; }
+
+    // Starts the records of one compiled source.
+    void file(std::string_view path);
+    // Every token of `tokens`, which were scanned from the source `lines` covers.
+    void tokens(const TokenBuffer& tokens, const LineTable& lines);
+    void rule(ParseRule rule, EventPosition where, std::string_view name = {});
+    void error(EventPosition where, std::string_view message);
+
+    void flush() { out.flush(); }
+
+private:
+    void jsonString(std::string_view text);
+    void jsonNumber(std::string_view key, uint32_t value);
+    void beginRecord(unsigned char kind, size_t payload);
+    void u8(unsigned char value) { out << static_cast<char>(value); }
+    void u16(uint16_t value);
+    void u32(uint32_t value);
+
+    EmitOptions options;
+    Report& out;
+    std::vector<std::string> typeNames; // tokenTypeToString, looked up once
+};
+
+#endif
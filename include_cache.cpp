@@ -0,0 +1,85 @@
+#include "include_cache.h"
+
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+const IncludeUnit* IncludeCache::load(std::string_view name, const std::string& directory, DiagCode& failure) {
+    failure = DiagCode::IncludeNotFound;
+    fs::path resolved(name);
+    if (resolved.is_relative() && !directory.empty()) resolved = fs::path(directory) / resolved;
+    std::string path = resolved.lexically_normal().string();
+
+    std::error_code ec;
+    std::string key = fs::weakly_canonical(fs::path(path), ec).string();
+    if (ec) return nullptr;
+    fs::file_time_type modified = fs::last_write_time(key, ec);
+    if (ec) return nullptr;
+    std::uintmax_t size = fs::file_size(key, ec);
+    if (ec) return nullptr;
+
+    auto cached = byPath.find(key);
+    if (cached != byPath.end() && cached->second->modified == modified && cached->second->size == size) {
+        return cached->second;
+    }
+
+    // The unit is built in place: its tokens and literals are views into
+    // `source`, which must not move afterwards.
+    auto unit = std::make_unique<IncludeUnit>();
+    if (!unit->source.load(key)) return nullptr;
+    size_t at = findRoom(unit->source.size(), unit->base);
+    if (at == none) {
+        failure = DiagCode::IncludeSpaceExhausted;
+        return nullptr;
+    }
+    unit->path = path;
+    unit->directory = fs::path(path).parent_path().string();
+    unit->lines = LineTable(unit->source.view());
+    unit->modified = modified;
+    unit->size = size;
+
+    Scanner<SkipTrivia> scanner(unit->source.view());
+    unit->tokens = scanner.scanTokens();
+    unit->errors = scanner.getErrors();
+    unit->literals = scanner.takeLiterals();
+
+    const IncludeUnit* loaded = units.insert(units.begin() + at, std::move(unit))->get();
+    if (cached != byPath.end()) superseded.push_back(cached->second);
+    byPath[key] = loaded;
+    return loaded;
+}
+
+size_t IncludeCache::findRoom(size_t size, uint32_t& base) const {
+    // One past the end stays free, for the unit's EndOfFile.
+    uint64_t needed = static_cast<uint64_t>(size) + 1;
+    uint64_t free = firstBase;
+    for (size_t i = 0; i <= units.size(); ++i) {
+        uint64_t next = i < units.size() ? units[i]->base : uint64_t(UINT32_MAX);
+        if (next - free >= needed) {
+            base = static_cast<uint32_t>(free);
+            return i;
+        }
+        if (i < units.size()) free = units[i]->base + units[i]->source.size() + 1;
+    }
+    return none;
+}
+
+void IncludeCache::releaseSuperseded() {
+    if (superseded.empty()) return;
+    units.erase(std::remove_if(units.begin(), units.end(), [this](const std::unique_ptr<IncludeUnit>& unit) {
+        return std::find(superseded.begin(), superseded.end(), unit.get()) != superseded.end();
+    }), units.end());
+    superseded.clear();
+}
+
+const IncludeUnit* IncludeCache::unitAt(SourceLoc loc) const {
+    if (loc.offset < firstBase) return nullptr;
+    auto next = std::upper_bound(units.begin(), units.end(), loc.offset,
+        [](uint32_t offset, const std::unique_ptr<IncludeUnit>& unit) { return offset < unit->base; });
+    return next == units.begin() ? nullptr : std::prev(next)->get();
+}
+
+LineColumn IncludeCache::position(SourceLoc loc, const LineTable& mainLines) const {
+    const IncludeUnit* unit = unitAt(loc);
+    return unit ? unit->lines.position(SourceLoc{loc.offset - unit->base}) : mainLines.position(loc);
+}
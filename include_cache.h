@@ -0,0 +1,77 @@
+#ifndef INCLUDE_CACHE_H
+#define INCLUDE_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "diagnostics.h"
+#include "scanner.h"
+#include "source_buffer.h"
+#include "source_loc.h"
+#include "token_buffer.h"
+
+// One included file, scanned once (without comments) and kept for the
+// life of the cache. Its tokens sit at SourceLoc offsets base + offset,
+// above every offset of a main source, so a location alone tells which
+// file it is in.
+struct IncludeUnit {
+    std::string path;      // as first resolved, for messages
+    std::string directory; // nested includes resolve against this
+    uint32_t base = 0;
+    SourceBuffer source;
+    LineTable lines{std::string_view()};
+    TokenBuffer tokens;
+    LiteralTable literals;
+    std::vector<Diagnostic> errors; // at unit offsets, not yet shifted by base
+    std::filesystem::file_time_type modified;
+    std::uintmax_t size = 0;
+};
+
+// Process-wide cache of included files keyed by canonical path. A file is
+// scanned again only when its modification time or size has changed. The
+// unit it replaces is kept until releaseSuperseded(), since tokens and
+// diagnostics of the compile in progress may still point into it; its
+// offsets are then free for later units.
+class IncludeCache {
+public:
+    // Offsets at or above this belong to included units.
+    static constexpr uint32_t firstBase = 1u << 31;
+
+    IncludeCache() = default;
+    IncludeCache(const IncludeCache&) = delete;
+    IncludeCache& operator=(const IncludeCache&) = delete;
+
+    // The unit for file `name`, or nullptr with `failure` set to why:
+    // IncludeNotFound if it cannot be read, IncludeSpaceExhausted if the
+    // offsets left cannot hold it. A relative `name` is taken relative to
+    // `directory`.
+    const IncludeUnit* load(std::string_view name, const std::string& directory, DiagCode& failure);
+
+    // Frees the units that newer scans of their files have replaced. Only
+    // call this between compiles.
+    void releaseSuperseded();
+
+    // The unit `loc` lies in, or nullptr for a location in a main source.
+    const IncludeUnit* unitAt(SourceLoc loc) const;
+
+    // Line and column of `loc` within its own file; `mainLines` covers
+    // locations in the main source.
+    LineColumn position(SourceLoc loc, const LineTable& mainLines) const;
+
+private:
+    // Where a unit of `size` bytes fits: the first gap between units that
+    // holds it and its EndOfFile. Returns the index in `units` to insert
+    // the unit at, and sets `base`, or returns `none`.
+    static constexpr size_t none = static_cast<size_t>(-1);
+    size_t findRoom(size_t size, uint32_t& base) const;
+
+    std::vector<std::unique_ptr<IncludeUnit>> units; // by base
+    std::unordered_map<std::string, const IncludeUnit*> byPath;
+    std::vector<const IncludeUnit*> superseded;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "interner.h"
+
+#include <cstring>
+
+StringInterner::StringInterner() : slots(1024, 0) {}
+
+uint32_t StringInterner::hash(std::string_view text) {
+    // FNV-1a: identifiers are short, so a byte loop is as fast as anything.
+    uint32_t h = 2166136261u;
+    for (char c : text) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+size_t StringInterner::slotOf(std::string_view text, uint32_t textHash) const {
+    size_t mask = slots.size() - 1;
+    for (size_t slot = textHash & mask;; slot = (slot + 1) & mask) {
+        uint32_t entry = slots[slot];
+        if (entry == 0) return slot;
+        Symbol symbol = entry - 1;
+        if (hashes[symbol] == textHash && names[symbol] == text) return slot;
+    }
+}
+
+Symbol StringInterner::intern(std::string_view text) {
+    uint32_t textHash = hash(text);
+    size_t slot = slotOf(text, textHash);
+    if (slots[slot] != 0) return slots[slot] - 1;
+
+    Symbol symbol = static_cast<Symbol>(names.size());
+    names.push_back(store(text));
+    hashes.push_back(textHash);
+    slots[slot] = symbol + 1;
+    // Keep the table at most half full so probe runs stay short.
+    if (names.size() * 2 > slots.size()) rehash();
+    return symbol;
+}
+
+Symbol StringInterner::find(std::string_view text) const {
+    uint32_t entry = slots[slotOf(text, hash(text))];
+    return entry == 0 ? noSymbol : entry - 1;
+}
+
+std::string_view StringInterner::store(std::string_view text) {
+    if (text.size() > remaining) {
+        // Names longer than a block get a block of their own.
+        size_t size = text.size() > blockSize ? text.size() : blockSize;
+        blocks.emplace_back(new char[size]);
+        cursor = blocks.back().get();
+        remaining = size;
+    }
+    char* copy = cursor;
+    if (!text.empty()) std::memcpy(copy, text.data(), text.size());
+    cursor += text.size();
+    remaining -= text.size();
+    return std::string_view(copy, text.size());
+}
+
+void StringInterner::rehash() {
+    std::vector<uint32_t> grown(slots.size() * 2, 0);
+    size_t mask = grown.size() - 1;
+    for (Symbol symbol = 0; symbol < names.size(); ++symbol) {
+        size_t slot = hashes[symbol] & mask;
+        while (grown[slot] != 0) slot = (slot + 1) & mask;
+        grown[slot] = symbol + 1;
+    }
+    slots.swap(grown);
+}
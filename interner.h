@@ -0,0 +1,48 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Dense id of an interned name; equal names get equal ids.
+using Symbol = uint32_t;
+constexpr Symbol noSymbol = UINT32_MAX;
+
+// Stores every distinct name once. The text lives in an arena of large
+// blocks, and lookups go through an open-addressing hash table of ids,
+// so interning a name that was seen before allocates nothing. Views
+// returned by name() stay valid for the life of the interner.
+class StringInterner {
+public:
+    StringInterner();
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // Id of `text`, adding it on first sight.
+    Symbol intern(std::string_view text);
+    // Id of `text`, or noSymbol if it was never interned.
+    Symbol find(std::string_view text) const;
+
+    std::string_view name(Symbol symbol) const { return names[symbol]; }
+    size_t size() const { return names.size(); }
+
+private:
+    static uint32_t hash(std::string_view text);
+    // Slot holding `text`, or the empty slot where it would go.
+    size_t slotOf(std::string_view text, uint32_t textHash) const;
+    std::string_view store(std::string_view text);
+    void rehash();
+
+    static constexpr size_t blockSize = 64 * 1024;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char* cursor = nullptr;
+    size_t remaining = 0;
+
+    std::vector<std::string_view> names; // by id, views into the arena
+    std::vector<uint32_t> hashes;        // by id
+    std::vector<uint32_t> slots;         // id + 1, or 0 when empty
+};
+
+#endif
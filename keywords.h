@@ -0,0 +1,100 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include "token.h"
+
+// Keyword recognition through a perfect hash that is built at compile time.
+// The hash only mixes the length with the first and last characters, so a
+// lookup is a range check, one table slot and at most one compare against
+// the source view: no hashing of the whole word and no heap work.
+namespace keywords {
+
+struct Entry {
+    string_view text;
+    TokenType type;
+};
+
+constexpr Entry list[] = {
+    {"IfTrue", TokenType::Condition},
+    {"Otherwise", TokenType::Condition},
+    {"Imw", TokenType::Integer},
+    {"SIMw", TokenType::SInteger},
+    {"Chj", TokenType::Character},
+    {"Series", TokenType::String},
+    {"IMwf", TokenType::Float},
+    {"SIMwf", TokenType::SFloat},
+    {"NOReturn", TokenType::Void},
+    {"RepeatWhen", TokenType::Loop},
+    {"Reiterate", TokenType::Loop},
+    {"Turnback", TokenType::Return},
+    {"OutLoop", TokenType::Break},
+    {"Loli", TokenType::Struct},
+    {"Include", TokenType::Include}
+};
+
+constexpr size_t tableSize = 32;
+
+constexpr size_t slotOf(size_t length, char first, char last) {
+    return (length + static_cast<unsigned char>(first) + static_cast<unsigned char>(last)) % tableSize;
+}
+
+constexpr size_t slotOf(string_view text) {
+    return slotOf(text.size(), text.front(), text.back());
+}
+
+constexpr size_t minLength() {
+    size_t result = list[0].text.size();
+    for (const Entry& entry : list) result = entry.text.size() < result ? entry.text.size() : result;
+    return result;
+}
+
+constexpr size_t maxLength() {
+    size_t result = 0;
+    for (const Entry& entry : list) result = entry.text.size() > result ? entry.text.size() : result;
+    return result;
+}
+
+constexpr bool isPerfect() {
+    for (size_t i = 0; i < std::size(list); ++i) {
+        for (size_t j = i + 1; j < std::size(list); ++j) {
+            if (slotOf(list[i].text) == slotOf(list[j].text)) return false;
+        }
+    }
+    return true;
+}
+
+static_assert(isPerfect(), "keyword hash collision: adjust slotOf()");
+
+constexpr std::array<Entry, tableSize> buildTable() {
+    std::array<Entry, tableSize> table{};
+    for (Entry& slot : table) slot = {string_view(), TokenType::Identifier};
+    for (const Entry& entry : list) table[slotOf(entry.text)] = entry;
+    return table;
+}
+
+constexpr std::array<Entry, tableSize> table = buildTable();
+
+// Token type of `text`: its keyword type, or Identifier.
+constexpr TokenType lookup(string_view text) {
+    // Every keyword is 3..10 characters and starts with a capital letter.
+    if (text.size() < minLength() || text.size() > maxLength()) return TokenType::Identifier;
+    if (text.front() < 'A' || text.front() > 'Z') return TokenType::Identifier;
+    const Entry& entry = table[slotOf(text)];
+    return entry.text == text ? entry.type : TokenType::Identifier;
+}
+
+constexpr bool findsEveryKeyword() {
+    for (const Entry& entry : list) {
+        if (lookup(entry.text) != entry.type) return false;
+    }
+    return true;
+}
+
+static_assert(findsEveryKeyword(), "keyword missed by the lookup pre-filter");
+
+} // namespace keywords
+
+#endif
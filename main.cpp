@@ -1,12 +1,67 @@
 #include "compiler.h"
+#include "diagnostics.h"
+#include "emit.h"
+#include "report.h"
+#include <charconv>
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <string_view>
 
 int main(int argc, char* argv[]) {
-    Compiler compiler;
+    // --verbosity=<quiet|errors|rules|tokens|source> picks how much is
+    // printed; -q is --verbosity=quiet. Errors and a summary by default.
+    // --max-errors=N stops each compile after N errors (0: no limit).
+    // --emit=tokens,parse-events writes machine-readable records to stdout
+    // (JSON Lines, or binary with --emit-format=binary); the report then
+    // goes to stderr.
+    Verbosity level = Verbosity::Errors;
+    EmitOptions emit;
+    bool emitting = false;
+    size_t errorLimit = Diagnostics::defaultErrorLimit;
+    const char* sourceFile = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (arg == "-q") {
+            level = Verbosity::Quiet;
+        } else if (arg.substr(0, 12) == "--verbosity=") {
+            if (!parseVerbosity(arg.substr(12), level)) {
+                std::cerr << "Unknown verbosity '" << arg.substr(12)
+                          << "' (expected quiet, errors, rules, tokens or source)\n";
+                return 2;
+            }
+        } else if (arg.substr(0, 13) == "--max-errors=") {
+            std::string_view count = arg.substr(13);
+            const char* end = count.data() + count.size();
+            if (count.empty() || std::from_chars(count.data(), end, errorLimit).ptr != end) {
+                std::cerr << "Invalid --max-errors '" << count << "' (expected a number)\n";
+                return 2;
+            }
+        } else if (arg.substr(0, 7) == "--emit=") {
+            if (!parseEmitKinds(arg.substr(7), emit)) {
+                std::cerr << "Unknown --emit list '" << arg.substr(7) << "' (expected tokens and/or parse-events)\n";
+                return 2;
+            }
+            emitting = true;
+        } else if (arg.substr(0, 14) == "--emit-format=") {
+            if (!parseEmitFormat(arg.substr(14), emit.format)) {
+                std::cerr << "Unknown --emit-format '" << arg.substr(14) << "' (expected jsonl or binary)\n";
+                return 2;
+            }
+        } else {
+            sourceFile = argv[i];
+        }
+    }
+
+    Report report(level, emitting ? stderr : stdout);
+    Report dump(Verbosity::Quiet, stdout);
+    std::unique_ptr<EventWriter> events;
+    if (emitting) events = std::make_unique<EventWriter>(emit, dump);
+    Compiler compiler(report, events.get(), errorLimit);
     
-    if (argc > 1) {
+    if (sourceFile) {
         // If a file is specified on the command line, compile it directly
-        compiler.compile(argv[1]);
+        compiler.compile(sourceFile);
     } else {
         // Otherwise, run the interactive mode
         compiler.run();
@@ -1,52 +1,132 @@
 #include "parser.h"
-#include <iostream>
-#include <stdexcept>
+#include <array>
+#include <climits>
 using namespace std;
 
-Parser::Parser(const vector<Token>& tokens, SymbolTable& symtab)
-    : tokens(tokens), symtab(symtab), current(0), errorCount(0) {}
+namespace {
+
+// How tightly each binary operator binds, keyed on token type; tokens that
+// are not binary operators have power 0. Operators are left-associative,
+// except comparisons, which do not chain. `||` and `&&` are reported as
+// matched rules under `name`.
+struct BinaryOperator {
+    unsigned char power = 0;
+    bool chains = true;
+    ParseRule rule = ParseRule::LogicalOr;
+    const char* name = nullptr;
+};
+
+constexpr size_t tokenTypeCount = static_cast<size_t>(TokenType::Invalid) + 1;
+
+constexpr array<BinaryOperator, tokenTypeCount> buildBinaryOperators() {
+    array<BinaryOperator, tokenTypeCount> table{};
+    auto set = [&table](TokenType type, BinaryOperator op) { table[static_cast<size_t>(type)] = op; };
+    set(TokenType::Or, {1, true, ParseRule::LogicalOr, "Logical OR expression"});
+    set(TokenType::And, {2, true, ParseRule::LogicalAnd, "Logical And expression"});
+    for (TokenType type : {TokenType::Less, TokenType::Greater, TokenType::Equal, TokenType::NotEqual,
+                           TokenType::LessEqual, TokenType::GreaterEqual}) {
+        set(type, {3, false});
+    }
+    set(TokenType::Plus, {4});
+    set(TokenType::Minus, {4});
+    set(TokenType::Multiply, {5});
+    set(TokenType::Divide, {5});
+    return table;
+}
+
+constexpr array<BinaryOperator, tokenTypeCount> binaryOperators = buildBinaryOperators();
+
+// Recovery: a statement that fails to parse is skipped up to its FOLLOW
+// set, the tokens that can start the next statement or close a block.
+// Identifiers are left out; after an error they are more often the rest
+// of the broken statement than the start of a new one.
+constexpr TokenSet statementStarts = {
+    TokenType::Integer, TokenType::SInteger, TokenType::Character, TokenType::String,
+    TokenType::Float,   TokenType::SFloat,   TokenType::Void,      TokenType::Condition,
+    TokenType::Loop,    TokenType::Return,   TokenType::Break,     TokenType::LeftBrace,
+};
+constexpr TokenSet statementFollow = statementStarts | TokenSet{TokenType::RightBrace};
+
+} // namespace
+
+Parser::Parser(Scanner<SkipTrivia>& scanner, SymbolTable& symtab, const LineTable& lines, Report& report,
+               Diagnostics& diagnostics, Arena& arena, const IncludeCache* includes, EventWriter* events)
+    : scanner(scanner), symtab(symtab), lines(lines), report(report), diagnostics(diagnostics), arena(arena),
+      includes(includes), events(events) {}
 
 bool Parser::isAtEnd() {
-    return current >= tokens.size() || tokens[current].type == TokenType::EndOfFile;
+    return scanner.peek(0).type == TokenType::EndOfFile;
 }
 
-const Token& Parser::advance() {
-    if (!isAtEnd()) current++;
-    return tokens[current - 1];
+Token Parser::advance() {
+    if (!isAtEnd()) {
+        previous = scanner.next();
+        consumed++;
+    }
+    return previous;
+}
+
+Token Parser::peek() {
+    return scanner.peek(0);
 }
 
-const Token& Parser::peek() {
-    return tokens[current];
+TokenType Parser::peekType() {
+    return scanner.peek(0).type;
+}
+
+int Parser::previousLine() const {
+    return position(previous.loc).line;
+}
+
+LineColumn Parser::position(SourceLoc loc) const {
+    return includes ? includes->position(loc, lines) : lines.position(loc);
+}
+
+EventPosition Parser::where(SourceLoc loc) const {
+    const IncludeUnit* unit = includes ? includes->unitAt(loc) : nullptr;
+    return {position(loc), unit ? string_view(unit->path) : string_view()};
+}
+
+void Parser::matched(ParseRule rule, string_view name) {
+    if (events) events->rule(rule, where(previous.loc), name);
 }
 
 bool Parser::match(TokenType type) {
-    if (!isAtEnd() && peek().type == type) {
+    if (!isAtEnd() && peekType() == type) {
         advance();
         return true;
     }
     return false;
 }
 
-void Parser::error(const string& message) {
-    cerr << "Parser Error at line " << peek().line << ": " << message << "\n";
-    errorCount++;
+void Parser::error(DiagCode code, const Token& quoted, uint32_t arg) {
+    diagnose(code, scanner.peek(0).loc, quoted, arg);
+}
+
+void Parser::diagnose(DiagCode code, SourceLoc at, const Token& quoted, uint32_t arg) {
+    takeScannerErrors();
+    diagnostics.add(Diagnostic{code, at, quoted.loc, static_cast<uint32_t>(quoted.lexeme.size()), arg});
+}
+
+void Parser::takeScannerErrors() {
+    const vector<Diagnostic>& errors = scanner.getErrors();
+    for (; scannerErrorsTaken < errors.size(); ++scannerErrorsTaken) diagnostics.add(errors[scannerErrorsTaken]);
+}
+
+void Parser::syntaxError(DiagCode code) {
+    error(code);
+    synchronize();
 }
 
 void Parser::synchronize() {
-    advance();
     while (!isAtEnd()) {
-        if (peek().type == TokenType::Semicolon) {
+        TokenType type = peekType();
+        if (type == TokenType::Semicolon) {
             advance();
             return;
         }
-        if (peek().type == TokenType::Integer || peek().type == TokenType::SInteger ||
-            peek().type == TokenType::Character || peek().type == TokenType::String ||
-            peek().type == TokenType::Float || peek().type == TokenType::SFloat ||
-            peek().type == TokenType::Void || peek().type == TokenType::Condition ||
-            peek().type == TokenType::Loop || peek().type == TokenType::Return ||
-            peek().type == TokenType::Break || peek().type == TokenType::LeftBrace) {
-            return;
-        }
+        // A '}' outside any block closes nothing and is skipped.
+        if (statementFollow.contains(type) && (type != TokenType::RightBrace || openBlocks > 0)) return;
         advance();
     }
 }
@@ -68,408 +148,445 @@ bool Parser::checkTypeCompatibility(SymbolType varType, const Token& valueToken)
     }
 }
 
-void Parser::parseProgram() {
-    cout << "\n--- Parser Output ---\n";
-    const size_t maxIterations = tokens.size() * 2;
-    size_t iterations = 0;
+template <typename T>
+Span<T> Parser::takeFrom(std::vector<T>& stack, size_t mark) {
+    Span<T> items = arena.copy(stack.data() + mark, stack.size() - mark);
+    stack.resize(mark);
+    return items;
+}
 
-    while (!isAtEnd() && iterations++ < maxIterations) {
-        if (peek().type == TokenType::SingleComment ||
-            peek().type == TokenType::SMultiComment ||
-            peek().type == TokenType::CommentContent ||
-            peek().type == TokenType::EMultiComment) {
-            handleComment();
-            continue;
-        }
+SymbolType Parser::typeOf(TokenType type) {
+    switch (type) {
+        case TokenType::Integer: return SymbolType::Integer;
+        case TokenType::SInteger: return SymbolType::SInteger;
+        case TokenType::Character: return SymbolType::Character;
+        case TokenType::String: return SymbolType::String;
+        case TokenType::Float: return SymbolType::Float;
+        case TokenType::SFloat: return SymbolType::SFloat;
+        case TokenType::Void: return SymbolType::Void;
+        default: return SymbolType::Unknown;
+    }
+}
 
-        try {
-            if (peek().type == TokenType::Integer || peek().type == TokenType::SInteger ||
-                peek().type == TokenType::Character || peek().type == TokenType::String ||
-                peek().type == TokenType::Float || peek().type == TokenType::SFloat ||
-                peek().type == TokenType::Void) {
-                if (current + 2 < tokens.size() &&
-                    tokens[current + 1].type == TokenType::Identifier &&
-                    tokens[current + 2].type == TokenType::LeftParen) {
-                    functionDefinition();
-                } else {
-                    declaration();
-                }
+Program* Parser::parseProgram() {
+    if (report.shows(Verbosity::Rules)) report << "\n--- Parser Output ---\n";
+    bool stuck = false;
+    SourceLoc start = peek().loc;
+    size_t items = nodes.size();
+
+    // Past the error limit nothing more would be reported, so stop.
+    while (!isAtEnd() && !diagnostics.limitReached()) {
+        size_t consumedBefore = consumed;
+        takeScannerErrors();
+
+        Node* item;
+        if (peekType() == TokenType::Integer || peekType() == TokenType::SInteger ||
+            peekType() == TokenType::Character || peekType() == TokenType::String ||
+            peekType() == TokenType::Float || peekType() == TokenType::SFloat ||
+            peekType() == TokenType::Void) {
+            if (scanner.peek(1).type == TokenType::Identifier &&
+                scanner.peek(2).type == TokenType::LeftParen) {
+                item = functionDefinition();
             } else {
-                statement();
+                item = declaration();
             }
-        } catch (const exception& e) {
-            error(string("Parsing error: ") + e.what());
-            synchronize();
+        } else {
+            item = statement();
         }
-    }
+        if (item) nodes.push_back(item);
 
-    if (iterations >= maxIterations) {
-        error("Parser stuck in infinite loop - aborting");
+        if (consumed == consumedBefore) {
+            stuck = true;
+            break;
+        }
     }
 
-    cerr << "\nTotal parser errors: " << errorCount << "\n";
+    if (stuck) {
+        error(DiagCode::ParserStuck);
+    }
+    takeScannerErrors();
+    return arena.make<Program>(start, takeFrom(nodes, items));
 }
 
-void Parser::declaration() {
+VarDecl* Parser::declaration() {
     Token typeToken = advance();
-    SymbolType varType;
-
-    switch (typeToken.type) {
-        case TokenType::Integer: varType = SymbolType::Integer; break;
-        case TokenType::SInteger: varType = SymbolType::SInteger; break;
-        case TokenType::Character: varType = SymbolType::Character; break;
-        case TokenType::String: varType = SymbolType::String; break;
-        case TokenType::Float: varType = SymbolType::Float; break;
-        case TokenType::SFloat: varType = SymbolType::SFloat; break;
-        default:
-            error("Invalid type");
-            return;
+    SymbolType varType = typeOf(typeToken.type);
+    if (varType == SymbolType::Unknown || varType == SymbolType::Void) {
+        syntaxError(DiagCode::InvalidType);
+        return nullptr;
     }
 
+    size_t first = declarators.size();
     do {
-        if (!match(TokenType::Identifier)) { error("Expected variable name"); return; }
-        string varName = tokens[current - 1].lexeme;
-
-        if (!symtab.declareVariable(varName, varType)) {
-            cerr << "Error: Variable '" << varName << "' already declared (line " << tokens[current - 1].line << ")\n";
+        if (!match(TokenType::Identifier)) {
+            declarators.resize(first);
+            syntaxError(DiagCode::ExpectedVariableName);
+            return nullptr;
+        }
+        Token name = previous;
+        if (!symtab.declareVariable(name.symbol, varType)) {
+            diagnose(DiagCode::VariableRedeclared, name.loc, name);
         }
 
+        Expr* init = nullptr;
         if (match(TokenType::Assignment)) {
-            if (peek().type == TokenType::IntgerConstant || peek().type == TokenType::FloatConstant ||
-                peek().type == TokenType::CharConstant || peek().type == TokenType::StringConstant) {
+            if (peekType() == TokenType::IntgerConstant || peekType() == TokenType::FloatConstant ||
+                peekType() == TokenType::CharConstant || peekType() == TokenType::StringConstant) {
                 Token valueToken = advance();
                 if (!checkTypeCompatibility(varType, valueToken)) {
-                    error("Type mismatch: Cannot assign " + valueToken.lexeme + " to variable of type " + symtab.typeToString(varType));
+                    error(DiagCode::TypeMismatch, valueToken, static_cast<uint32_t>(varType));
                 }
+                init = literal(valueToken);
             } else {
-                expression();
-                cout << "Warning: Type checking for complex expressions not fully implemented (line " << peek().line << ")\n";
+                init = expression();
+                if (!init) {
+                    declarators.resize(first);
+                    synchronize();
+                    return nullptr;
+                }
+                diagnose(DiagCode::UncheckedExpression, scanner.peek(0).loc);
             }
         }
+        declarators.push_back(Declarator{name.symbol, name.loc, init});
     } while (match(TokenType::Comma));
 
-    if (!match(TokenType::Semicolon)) { error("Expected ';'"); return; }
+    if (!match(TokenType::Semicolon)) {
+        declarators.resize(first);
+        syntaxError(DiagCode::ExpectedSemicolon);
+        return nullptr;
+    }
 
-    cout << "Matched: var-declaration    Line::  " << peek().line - 1 << "\n";
+    matched(ParseRule::VarDeclaration);
+    if (report.shows(Verbosity::Rules)) {
+        report << "Matched: var-declaration    Line::  " << previousLine() << '\n';
+    }
+    return arena.make<VarDecl>(typeToken.loc, varType, takeFrom(declarators, first));
 }
 
-void Parser::functionDefinition() {
+FunDecl* Parser::functionDefinition() {
     symtab.enterScope(); // Enter function scope
 
     Token returnType = advance();
-    SymbolType returnSymType;
-
-    switch (returnType.type) {
-        case TokenType::Integer: returnSymType = SymbolType::Integer; break;
-        case TokenType::SInteger: returnSymType = SymbolType::SInteger; break;
-        case TokenType::Character: returnSymType = SymbolType::Character; break;
-        case TokenType::String: returnSymType = SymbolType::String; break;
-        case TokenType::Float: returnSymType = SymbolType::Float; break;
-        case TokenType::SFloat: returnSymType = SymbolType::SFloat; break;
-        case TokenType::Void: returnSymType = SymbolType::Void; break;
-        default:
-            error("Invalid return type");
-            symtab.exitScope();
-            return;
+    SymbolType returnSymType = typeOf(returnType.type);
+    if (returnSymType == SymbolType::Unknown) {
+        symtab.exitScope();
+        syntaxError(DiagCode::InvalidReturnType);
+        return nullptr;
     }
 
     if (!match(TokenType::Identifier)) {
-        error("Expected function name");
         symtab.exitScope();
-        return;
+        syntaxError(DiagCode::ExpectedFunctionName);
+        return nullptr;
     }
-    string funcName = tokens[current - 1].lexeme;
+    Token funcName = previous;
 
     if (!match(TokenType::LeftParen)) {
-        error("Expected '(' after function name");
         symtab.exitScope();
-        return;
+        syntaxError(DiagCode::ExpectedParenAfterFunctionName);
+        return nullptr;
     }
 
-    vector<pair<string, SymbolType>> parameters;
+    // Every early return below leaves params[firstParam...] behind; they
+    // are dropped there.
+    size_t firstParam = params.size();
+    auto fail = [&](DiagCode code, const Token& quoted = Token()) -> FunDecl* {
+        params.resize(firstParam);
+        error(code, quoted);
+        symtab.exitScope();
+        synchronize();
+        return nullptr;
+    };
     vector<SymbolType> paramTypes;
     while (!match(TokenType::RightParen)) {
-        if (peek().type == TokenType::Integer || peek().type == TokenType::SInteger ||
-            peek().type == TokenType::Character || peek().type == TokenType::String ||
-            peek().type == TokenType::Float || peek().type == TokenType::SFloat) {
+        if (peekType() == TokenType::Integer || peekType() == TokenType::SInteger ||
+            peekType() == TokenType::Character || peekType() == TokenType::String ||
+            peekType() == TokenType::Float || peekType() == TokenType::SFloat) {
             Token paramType = advance();
-            SymbolType paramSymType;
-            switch (paramType.type) {
-                case TokenType::Integer: paramSymType = SymbolType::Integer; break;
-                case TokenType::SInteger: paramSymType = SymbolType::SInteger; break;
-                case TokenType::Character: paramSymType = SymbolType::Character; break;
-                case TokenType::String: paramSymType = SymbolType::String; break;
-                case TokenType::Float: paramSymType = SymbolType::Float; break;
-                case TokenType::SFloat: paramSymType = SymbolType::SFloat; break;
-                default:
-                    error("Invalid parameter type");
-                    symtab.exitScope();
-                    return;
-            }
-            if (!match(TokenType::Identifier)) {
-                error("Expected parameter name");
-                symtab.exitScope();
-                return;
-            }
-            string paramName = tokens[current - 1].lexeme;
-            parameters.emplace_back(paramName, paramSymType);
+            SymbolType paramSymType = typeOf(paramType.type);
+            if (!match(TokenType::Identifier)) return fail(DiagCode::ExpectedParameterName);
+            params.push_back(Param{paramSymType, previous.symbol, previous.loc});
             paramTypes.push_back(paramSymType);
-            symtab.declareVariable(paramName, paramSymType);
+            symtab.declareVariable(previous.symbol, paramSymType);
         }
-        if (!match(TokenType::Comma) && peek().type != TokenType::RightParen) {
-            error("Expected ',' or ')' in parameter list");
-            symtab.exitScope();
-            return;
+        if (!match(TokenType::Comma) && peekType() != TokenType::RightParen) {
+            return fail(DiagCode::ExpectedParameterSeparator);
         }
     }
 
-    if (!symtab.declareFunction(funcName, returnSymType, paramTypes)) {
-        error("Function '" + funcName + "' already declared");
-        symtab.exitScope();
-        return;
+    if (!symtab.declareFunction(funcName.symbol, returnSymType, paramTypes)) {
+        return fail(DiagCode::FunctionRedeclared, funcName);
     }
 
-    if (!match(TokenType::LeftBrace)) {
-        error("Expected '{' at start of function body");
-        symtab.exitScope();
-        return;
-    }
+    if (!match(TokenType::LeftBrace)) return fail(DiagCode::ExpectedFunctionBody);
 
+    size_t firstStatement = nodes.size();
+    openBlocks++;
     while (!match(TokenType::RightBrace)) {
-        statement();
+        if (Node* statement = this->statement()) nodes.push_back(statement);
         if (isAtEnd()) {
-            error("Unterminated function body");
-            symtab.exitScope();
-            return;
+            openBlocks--;
+            nodes.resize(firstStatement);
+            return fail(DiagCode::UnterminatedFunctionBody);
         }
     }
-
-    cout << "Matched: fun-declaration (" << funcName << ") Line::  " << peek().line - 1 << "\n";
-    if (!parameters.empty()) {
-        cout << "Parameters:\n";
-        for (const auto& param : parameters) {
-            cout << "  - " << param.first << " (" << symtab.typeToString(param.second) << ")\n";
+    openBlocks--;
+
+    Span<Param> parameters = takeFrom(params, firstParam);
+    matched(ParseRule::FunDeclaration, funcName.lexeme);
+    if (report.shows(Verbosity::Rules)) {
+        report << "Matched: fun-declaration (" << funcName.lexeme << ") Line::  " << previousLine() << '\n';
+        if (!parameters.empty()) {
+            report << "Parameters:\n";
+            for (const Param& param : parameters) {
+                report << "  - " << symtab.name(param.name) << " (" << symtab.typeToString(param.type) << ")\n";
+            }
         }
     }
 
     symtab.exitScope(); // Exit function scope
+    return arena.make<FunDecl>(returnType.loc, returnSymType, funcName.symbol, parameters,
+                               takeFrom(nodes, firstStatement));
 }
 
-void Parser::statement() {
-    if (peek().type == TokenType::SingleComment ||
-        peek().type == TokenType::SMultiComment ||
-        peek().type == TokenType::CommentContent ||
-        peek().type == TokenType::EMultiComment) {
-        handleComment();
-        return;
-    }
-
-    if (peek().type == TokenType::Identifier) {
-        assignment();
-    } else if (peek().type == TokenType::Condition) {
-        selectionStatement();
-    } else if (peek().type == TokenType::Loop) {
-        iterationStatement();
-    } else if (peek().type == TokenType::Return || peek().type == TokenType::Break) {
-        jumpStatement();
-    } else if (peek().type == TokenType::LeftBrace) {
-        block();
-    } else if (peek().type == TokenType::Void) {
-        functionDefinition();
-    } else if (peek().type == TokenType::Semicolon) {
+Node* Parser::statement() {
+    if (peekType() == TokenType::Identifier) {
+        return assignment();
+    } else if (peekType() == TokenType::Condition) {
+        return selectionStatement();
+    } else if (peekType() == TokenType::Loop) {
+        return iterationStatement();
+    } else if (peekType() == TokenType::Return || peekType() == TokenType::Break) {
+        return jumpStatement();
+    } else if (peekType() == TokenType::LeftBrace) {
+        return block();
+    } else if (peekType() == TokenType::Void) {
+        return functionDefinition();
+    } else if (peekType() == TokenType::Semicolon) {
         match(TokenType::Semicolon);
-        cout << "Matched: Empty Statement\n";
-    } else if (peek().type == TokenType::Integer || peek().type == TokenType::SInteger ||
-               peek().type == TokenType::Character || peek().type == TokenType::String ||
-               peek().type == TokenType::Float || peek().type == TokenType::SFloat) {
-        if (current + 2 < tokens.size() &&
-            tokens[current + 1].type == TokenType::Identifier &&
-            tokens[current + 2].type == TokenType::LeftParen) {
-            functionDefinition();
+        matched(ParseRule::EmptyStatement);
+        if (report.shows(Verbosity::Rules)) report << "Matched: Empty Statement\n";
+        return arena.make<EmptyStmt>(previous.loc);
+    } else if (peekType() == TokenType::Integer || peekType() == TokenType::SInteger ||
+               peekType() == TokenType::Character || peekType() == TokenType::String ||
+               peekType() == TokenType::Float || peekType() == TokenType::SFloat) {
+        if (scanner.peek(1).type == TokenType::Identifier &&
+            scanner.peek(2).type == TokenType::LeftParen) {
+            return functionDefinition();
         } else {
-            declaration();
+            return declaration();
         }
     } else {
-        expressionStatement();
+        return expressionStatement();
     }
 }
 
-void Parser::expressionStatement() {
-    expression();
-    if (!match(TokenType::Semicolon)) { error("Expected ';'"); return; }
-    cout << "Matched: Expression Statement\n";
+ExprStmt* Parser::expressionStatement() {
+    SourceLoc start = peek().loc;
+    Expr* expr = expression();
+    if (!expr) {
+        synchronize();
+        return nullptr;
+    }
+    if (!match(TokenType::Semicolon)) { syntaxError(DiagCode::ExpectedSemicolon); return nullptr; }
+    matched(ParseRule::ExpressionStatement);
+    if (report.shows(Verbosity::Rules)) report << "Matched: Expression Statement\n";
+    return arena.make<ExprStmt>(start, expr);
 }
 
-void Parser::selectionStatement() {
-    advance();
-    if (!match(TokenType::LeftParen)) { error("Expected '('"); return; }
-    expression();
-    if (!match(TokenType::RightParen)) { error("Expected ')'"); return; }
+IfStmt* Parser::selectionStatement() {
+    SourceLoc start = advance().loc;
+    if (!match(TokenType::LeftParen)) { syntaxError(DiagCode::ExpectedLeftParen); return nullptr; }
+    Expr* condition = expression();
+    if (!condition) {
+        synchronize();
+        return nullptr;
+    }
+    if (!match(TokenType::RightParen)) { syntaxError(DiagCode::ExpectedRightParen); return nullptr; }
 
-    statement();
+    Node* then = statement();
+    Node* otherwise = nullptr;
 
-    if (peek().type == TokenType::Condition) {
+    if (peekType() == TokenType::Condition) {
         advance();
-        statement();
+        otherwise = statement();
     }
 
-    cout << "Matched: If/Else Statement    Line::  " << peek().line - 1 << "\n";
+    matched(ParseRule::IfElseStatement);
+    if (report.shows(Verbosity::Rules)) {
+        report << "Matched: If/Else Statement    Line::  " << previousLine() << '\n';
+    }
+    return arena.make<IfStmt>(start, condition, then, otherwise);
 }
 
-void Parser::iterationStatement() {
+LoopStmt* Parser::iterationStatement() {
     Token loopToken = advance();
     if (!match(TokenType::LeftParen)) {
-        error("Expected '(' after loop condition");
-        return;
+        syntaxError(DiagCode::ExpectedLoopLeftParen);
+        return nullptr;
     }
 
-    expression();
+    Expr* condition = expression();
+    if (!condition) {
+        synchronize();
+        return nullptr;
+    }
     if (!match(TokenType::RightParen)) {
-        error("Expected ')' after loop condition");
-        return;
+        syntaxError(DiagCode::ExpectedLoopRightParen);
+        return nullptr;
     }
 
-    statement();
+    Node* body = statement();
 
-    cout << "Matched: Iteration-Statement (" << loopToken.lexeme << ") Line::  " << peek().line - 1 << "\n";
+    matched(ParseRule::IterationStatement, loopToken.lexeme);
+    if (report.shows(Verbosity::Rules)) {
+        report << "Matched: Iteration-Statement (" << loopToken.lexeme << ") Line::  " << previousLine() << '\n';
+    }
+    LoopKeyword keyword = loopToken.lexeme == "Reiterate" ? LoopKeyword::Reiterate : LoopKeyword::RepeatWhen;
+    return arena.make<LoopStmt>(loopToken.loc, keyword, condition, body);
 }
 
-void Parser::jumpStatement() {
+Node* Parser::jumpStatement() {
     Token jumpTok = advance();
     if (jumpTok.type == TokenType::Return) {
-        expression();
-        if (!match(TokenType::Semicolon)) { error("Expected ';'"); return; }
-        cout << "Matched: Jump-Statement\n";
+        Expr* value = expression();
+        if (!value) {
+            synchronize();
+            return nullptr;
+        }
+        if (!match(TokenType::Semicolon)) { syntaxError(DiagCode::ExpectedSemicolon); return nullptr; }
+        matched(ParseRule::JumpStatement);
+        if (report.shows(Verbosity::Rules)) report << "Matched: Jump-Statement\n";
+        return arena.make<ReturnStmt>(jumpTok.loc, value);
     } else if (jumpTok.type == TokenType::Break) {
-        if (!match(TokenType::Semicolon)) { error("Expected ';'"); return; }
-        cout << "Matched: Jump-Statement\n";
+        if (!match(TokenType::Semicolon)) { syntaxError(DiagCode::ExpectedSemicolon); return nullptr; }
+        matched(ParseRule::JumpStatement);
+        if (report.shows(Verbosity::Rules)) report << "Matched: Jump-Statement\n";
+        return arena.make<BreakStmt>(jumpTok.loc);
     }
+    return nullptr;
 }
 
-void Parser::assignment() {
-    if (!match(TokenType::Identifier)) { error("Expected identifier"); return; }
-    string varName = tokens[current - 1].lexeme;
+AssignStmt* Parser::assignment() {
+    if (!match(TokenType::Identifier)) { syntaxError(DiagCode::ExpectedIdentifier); return nullptr; }
+    Token variable = previous;
 
-    if (!symtab.exists(varName)) {
-        cerr << "Error: Variable '" << varName << "' not declared before use (line " << tokens[current - 1].line << ")\n";
+    if (!symtab.exists(variable.symbol)) {
+        diagnose(DiagCode::UndeclaredAssignment, variable.loc, variable);
     }
 
-    if (!match(TokenType::Assignment)) { error("Expected '='"); return; }
+    if (!match(TokenType::Assignment)) { syntaxError(DiagCode::ExpectedAssignment); return nullptr; }
 
-    if (peek().type == TokenType::IntgerConstant || peek().type == TokenType::FloatConstant ||
-        peek().type == TokenType::CharConstant || peek().type == TokenType::StringConstant) {
+    Expr* value;
+    if (peekType() == TokenType::IntgerConstant || peekType() == TokenType::FloatConstant ||
+        peekType() == TokenType::CharConstant || peekType() == TokenType::StringConstant) {
         Token valueToken = advance();
-        SymbolType varType = symtab.getVariableType(varName);
-        if (!checkTypeCompatibility(varType, valueToken)) {
-            error("Type mismatch: Cannot assign " + valueToken.lexeme + " to variable of type " + symtab.typeToString(varType));
+        // Unknown for an undeclared variable, which was reported above.
+        SymbolType varType = symtab.getVariableType(variable.symbol);
+        if (varType != SymbolType::Unknown && !checkTypeCompatibility(varType, valueToken)) {
+            error(DiagCode::TypeMismatch, valueToken, static_cast<uint32_t>(varType));
         }
+        value = literal(valueToken);
     } else {
-        expression();
+        value = expression();
+        if (!value) {
+            synchronize();
+            return nullptr;
+        }
     }
 
-    if (!match(TokenType::Semicolon)) { error("Expected ';'"); return; }
+    if (!match(TokenType::Semicolon)) { syntaxError(DiagCode::ExpectedSemicolon); return nullptr; }
 
-    cout << "Matched: Assignment    Line::  " << peek().line - 1 << "\n";
+    matched(ParseRule::Assignment);
+    if (report.shows(Verbosity::Rules)) report << "Matched: Assignment    Line::  " << previousLine() << '\n';
+    return arena.make<AssignStmt>(variable.loc, variable.symbol, value);
 }
 
-void Parser::expression() {
-    logicalOrExpression();
+Expr* Parser::expression() {
+    return binary(0);
 }
 
-void Parser::logicalOrExpression() {
-    logicalAndExpression();
-    while (match(TokenType::Or)) {
-        logicalAndExpression();
-        cout << "Matched: Logical OR expression Line::  " << peek().line - 1 << "\n";
-    }
-}
-
-void Parser::logicalAndExpression() {
-    simpleExpression();
-    while (match(TokenType::And)) {
-        simpleExpression();
-        cout << "Matched: Logical And expression Line::  " << peek().line - 1 << "\n";
-    }
-}
-
-void Parser::simpleExpression() {
-    additiveExpression();
-    if (peek().type == TokenType::Less || peek().type == TokenType::Greater ||
-        peek().type == TokenType::Equal || peek().type == TokenType::NotEqual ||
-        peek().type == TokenType::LessEqual || peek().type == TokenType::GreaterEqual) {
-        advance();
-        additiveExpression();
-    }
-}
-
-void Parser::additiveExpression() {
-    term();
-    while (peek().type == TokenType::Plus || peek().type == TokenType::Minus) {
+Expr* Parser::binary(unsigned char above) {
+    Expr* left = unary();
+    if (!left) return nullptr;
+    // After a comparison only looser operators may follow: a < b < c
+    // leaves the second '<' to the caller.
+    unsigned char ceiling = UCHAR_MAX;
+    for (;;) {
+        TokenType op = peekType();
+        const BinaryOperator& rule = binaryOperators[static_cast<size_t>(op)];
+        if (rule.power <= above || rule.power >= ceiling) break;
         advance();
-        term();
+        Expr* right = binary(rule.power);
+        if (!right) return nullptr;
+        left = arena.make<BinaryExpr>(left->loc, op, left, right);
+        if (!rule.chains) ceiling = rule.power;
+        if (rule.name) {
+            matched(rule.rule);
+            if (report.shows(Verbosity::Rules)) {
+                report << "Matched: " << rule.name << " Line::  " << previousLine() << '\n';
+            }
+        }
     }
+    return left;
 }
 
-void Parser::term() {
-    factor();
-    while (peek().type == TokenType::Multiply || peek().type == TokenType::Divide) {
-        advance();
-        factor();
-    }
+Expr* Parser::unary() {
+    if (peekType() != TokenType::Minus && peekType() != TokenType::Not) return factor();
+    Token op = advance();
+    Expr* operand = unary();
+    return operand ? arena.make<UnaryExpr>(op.loc, op.type, operand) : nullptr;
 }
 
-void Parser::factor() {
+Expr* Parser::factor() {
     if (match(TokenType::LeftParen)) {
-        expression();
+        Expr* inner = expression();
+        if (!inner) return nullptr;
         if (!match(TokenType::RightParen)) {
-            error("Expected ')'");
-            throw runtime_error("Unmatched parenthesis");
+            error(DiagCode::ExpectedRightParen);
+            return nullptr;
         }
+        return inner;
     } else if (match(TokenType::Identifier)) {
-        if (!symtab.exists(tokens[current - 1].lexeme)) {
-            cerr << "Error: Undefined variable '" << tokens[current - 1].lexeme
-                 << "' (line " << tokens[current - 1].line << ")\n";
+        if (!symtab.exists(previous.symbol)) {
+            diagnose(DiagCode::UndefinedVariable, previous.loc, previous);
         }
+        return arena.make<NameExpr>(previous.loc, previous.symbol);
     } else if (match(TokenType::IntgerConstant) || match(TokenType::FloatConstant) ||
                match(TokenType::CharConstant) || match(TokenType::StringConstant)) {
-        // constant is ok
+        return literal(previous);
     } else {
-        error("Expected expression factor");
-        throw runtime_error("Invalid factor");
+        error(DiagCode::ExpectedFactor);
+        return nullptr;
     }
 }
 
-void Parser::handleComment() {
-    if (match(TokenType::SingleComment)) {
-        if (match(TokenType::CommentContent)) {
-            cout << "Matched: Single-line comment: " << tokens[current - 1].lexeme << "\n";
-        }
-    } else if (match(TokenType::SMultiComment)) {
-        while (!isAtEnd() && peek().type != TokenType::EMultiComment) {
-            if (match(TokenType::CommentContent)) {
-                cout << "Matched: Multi-line comment part: " << tokens[current - 1].lexeme << "\n";
-            } else {
-                advance();
-            }
-        }
-        if (match(TokenType::EMultiComment)) {
-            cout << "Matched: Multi-line comment end\n";
-        }
-    } else {
-        advance();
-    }
+LiteralExpr* Parser::literal(const Token& token) {
+    return arena.make<LiteralExpr>(token.loc, token.type, token.literal);
 }
 
-void Parser::block() {
-    symtab.enterScope();
-    if (!match(TokenType::LeftBrace)) { error("Expected '{'"); return; }
+Block* Parser::block() {
+    SourceLoc start = peek().loc;
+    if (!match(TokenType::LeftBrace)) { syntaxError(DiagCode::ExpectedLeftBrace); return nullptr; }
 
-    while (peek().type != TokenType::RightBrace && !isAtEnd()) {
-        statement();
+    // Opened only once '{' is matched, and closed on every return below.
+    symtab.enterScope();
+    size_t first = nodes.size();
+    openBlocks++;
+    while (peekType() != TokenType::RightBrace && !isAtEnd()) {
+        if (Node* statement = this->statement()) nodes.push_back(statement);
     }
+    openBlocks--;
 
-    if (!match(TokenType::RightBrace)) { error("Expected '}'"); return; }
+    if (!match(TokenType::RightBrace)) {
+        nodes.resize(first);
+        symtab.exitScope();
+        syntaxError(DiagCode::ExpectedRightBrace);
+        return nullptr;
+    }
 
-    cout << "Matched: Block    Line::  " << peek().line - 1 << "\n";
+    matched(ParseRule::Block);
+    if (report.shows(Verbosity::Rules)) report << "Matched: Block    Line::  " << previousLine() << '\n';
     symtab.exitScope();
+    return arena.make<Block>(start, takeFrom(nodes, first));
 }
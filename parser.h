@@ -3,51 +3,93 @@
 
 #include <vector>
 #include <string>
-#include <unordered_set>
 #include "token.h"
+#include "arena.h"
+#include "ast.h"
+#include "diagnostics.h"
+#include "emit.h"
+#include "include_cache.h"
+#include "report.h"
+#include "scanner.h"
+#include "source_loc.h"
 #include "symbol_table.h"
 
 using std::string;
 
 class Parser {
 public:
-    Parser(const std::vector<Token>& tokens, SymbolTable& symtab);
-    void parseProgram();
-    int getErrorCount() const { return errorCount; }
+    // Pulls tokens from `scanner` as it parses; at most three tokens of
+    // lookahead are needed, so the stream is never held in memory. The
+    // scanner drops comments, so the grammar never sees them. `lines`
+    // turns token locations into the line numbers that are printed;
+    // `includes` does the same for tokens spliced in from included files.
+    // Matched rules go to `report`, at its verbosity, and to `events` as
+    // parse events when it is given; errors are recorded in `diagnostics`,
+    // the scanner's among them.
+    // Syntax tree nodes are allocated in `arena`.
+    Parser(Scanner<SkipTrivia>& scanner, SymbolTable& symtab, const LineTable& lines, Report& report,
+           Diagnostics& diagnostics, Arena& arena, const IncludeCache* includes = nullptr,
+           EventWriter* events = nullptr);
+    // The tree of the whole source; it lives as long as the arena. Parts
+    // that did not parse are left out (or null, inside a statement).
+    Program* parseProgram();
 
 private:
-    const std::vector<Token>& tokens;
+    Scanner<SkipTrivia>& scanner;
     SymbolTable& symtab;
-    size_t current = 0;
-    int errorCount = 0;
-    int lastErrorLine = -1; // Track the last line where an error occurred
-    std::unordered_set<int> linesWithErrors; // Track all lines with errors
+    const LineTable& lines;
+    Report& report;
+    Diagnostics& diagnostics;
+    Arena& arena;
+    const IncludeCache* includes;
+    EventWriter* events;
+    Token previous;       // last consumed token
+    size_t consumed = 0;  // tokens consumed so far
+    size_t openBlocks = 0; // blocks and function bodies being parsed
+    size_t scannerErrorsTaken = 0;
+
+    // Lists being collected, innermost last; each construct takes its
+    // entries from a mark to the top into the arena when it is complete.
+    std::vector<Node*> nodes;
+    std::vector<Declarator> declarators;
+    std::vector<Param> params;
+    template <typename T>
+    Span<T> takeFrom(std::vector<T>& stack, size_t mark);
 
     bool isAtEnd();
-    const Token& advance();
-    const Token& peek();
+    Token advance();
+    Token peek();
+    TokenType peekType();
+    int previousLine() const; // line of the last consumed token
+    LineColumn position(SourceLoc loc) const;
+    EventPosition where(SourceLoc loc) const;
+    void matched(ParseRule rule, string_view name = {}); // parse event at the last consumed token
     bool match(TokenType type);
-    void error(const string& message);
-    void synchronize();
+    // `code` at the next token, quoting `quoted` if the message does.
+    void error(DiagCode code, const Token& quoted = Token(), uint32_t arg = 0);
+    void diagnose(DiagCode code, SourceLoc at, const Token& quoted = Token(), uint32_t arg = 0);
+    // Moves the scanner's new errors into `diagnostics`. They go in before
+    // any parser error they lead to, so on a shared line the scanner's is kept.
+    void takeScannerErrors();
+    void synchronize(); // skips the rest of a statement that failed to parse
+    void syntaxError(DiagCode code); // error() at the next token, then synchronize()
     bool checkTypeCompatibility(SymbolType varType, const Token& valueToken);
+    static SymbolType typeOf(TokenType type); // of a type keyword; Unknown for anything else
 
-    void declaration();
-    void functionDefinition();
-    void statement();
-    void expressionStatement();
-    void selectionStatement();
-    void iterationStatement();
-    void jumpStatement();
-    void assignment();
-    void expression();
-    void logicalOrExpression();
-    void logicalAndExpression();
-    void simpleExpression();
-    void additiveExpression();
-    void term();
-    void factor();
-    void block();
-    void handleComment();
+    VarDecl* declaration();
+    FunDecl* functionDefinition();
+    Node* statement();
+    ExprStmt* expressionStatement();
+    IfStmt* selectionStatement();
+    LoopStmt* iterationStatement();
+    Node* jumpStatement();
+    AssignStmt* assignment();
+    Expr* expression();
+    Expr* binary(unsigned char above); // only operators that bind tighter than `above`
+    Expr* unary();
+    Expr* factor();
+    LiteralExpr* literal(const Token& token);
+    Block* block();
 };
 
 #endif // PARSER_H_INCLUDED
@@ -0,0 +1,58 @@
+#include "report.h"
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+bool parseVerbosity(std::string_view name, Verbosity& level) {
+    static constexpr std::pair<std::string_view, Verbosity> names[] = {
+        {"quiet", Verbosity::Quiet},   {"errors", Verbosity::Errors}, {"rules", Verbosity::Rules},
+        {"tokens", Verbosity::Tokens}, {"source", Verbosity::Source},
+    };
+    for (const auto& entry : names) {
+        if (entry.first == name) {
+            level = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+Report::Report(Verbosity level, std::FILE* out) : level(level), out(out) {
+    buffer.reserve(capacity);
+}
+
+Report::~Report() {
+    flush();
+}
+
+Report& Report::operator<<(std::string_view text) {
+    if (buffer.size() + text.size() <= capacity) {
+        buffer.append(text);
+        return *this;
+    }
+    // Large pieces (a whole source file) skip the buffer.
+    flush();
+    if (text.size() >= capacity) {
+        std::fwrite(text.data(), 1, text.size(), out);
+    } else {
+        buffer.append(text);
+    }
+    return *this;
+}
+
+void Report::flush() {
+    if (!buffer.empty()) {
+        std::fwrite(buffer.data(), 1, buffer.size(), out);
+        buffer.clear();
+    }
+    std::fflush(out);
+}
+
+void Report::binary() {
+    flush();
+#ifdef _WIN32
+    _setmode(_fileno(out), _O_BINARY);
+#endif
+}
@@ -0,0 +1,64 @@
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// How much the compiler prints. Each level includes everything below it.
+enum class Verbosity : unsigned char {
+    Quiet,  // nothing
+    Errors, // diagnostics and a one-line summary (the default)
+    Rules,  // section headers, every rule the parser matches, totals
+    Tokens, // the scanner's token listing
+    Source, // the source text itself
+};
+
+// Parses "quiet", "errors", "rules", "tokens" or "source".
+bool parseVerbosity(std::string_view name, Verbosity& level);
+
+// The single sink for compiler output. Text is formatted into a large
+// buffer and handed to `out` in big writes, instead of going through
+// iostreams a line at a time. Callers check shows() before formatting, so
+// suppressed output costs nothing:
+//
+//     if (report.shows(Verbosity::Rules)) report << "Matched: Block\n";
+class Report {
+public:
+    explicit Report(Verbosity level = Verbosity::Errors, std::FILE* out = stdout);
+    ~Report();
+    Report(const Report&) = delete;
+    Report& operator=(const Report&) = delete;
+
+    bool shows(Verbosity detail) const { return detail <= level; }
+
+    Report& operator<<(std::string_view text);
+    Report& operator<<(const char* text) { return *this << std::string_view(text); }
+    Report& operator<<(const std::string& text) { return *this << std::string_view(text); }
+    Report& operator<<(char c) {
+        buffer.push_back(c);
+        if (buffer.size() >= capacity) flush();
+        return *this;
+    }
+    template <typename Int, typename = std::enable_if_t<std::is_integral_v<Int>>>
+    Report& operator<<(Int value) {
+        char digits[24];
+        return *this << std::string_view(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr - digits);
+    }
+
+    // Writes out everything buffered so far.
+    void flush();
+    // Writes bytes through unchanged from here on; on Windows the stream is
+    // otherwise in text mode and every '\n' written becomes "\r\n".
+    void binary();
+
+private:
+    static constexpr size_t capacity = 64 * 1024;
+    Verbosity level;
+    std::FILE* out;
+    std::string buffer;
+};
+
+#endif
@@ -1,175 +1,322 @@
 // src/scanner.cpp
 #include"scanner.h"
 #include "token.h"
-#include <cctype>
+#include "keywords.h"
+#include "simd_scan.h"
+#include "include_cache.h"
+#include "unicode.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <limits>
 #include <iostream>
-#include <unordered_map>
+#include <thread>
 using namespace std;
 
-Scanner::Scanner(const string& source) : source(source) {}
+template <typename Trivia>
+Scanner<Trivia>::Scanner(string_view source, StringInterner* names) : source(source), names(names) {}
 
-vector<Token> Scanner::scanTokens() {
-    while (!isAtEnd()) {
-        start = current;
+template <typename Trivia>
+Scanner<Trivia>::Scanner(string_view source, size_t begin)
+    : source(source), current(begin) {}
+
+template <typename Trivia>
+TokenBuffer Scanner<Trivia>::scanTokens() {
+    TokenBuffer tokens(source);
+    // Typical sources average well under one token per 8 bytes.
+    tokens.reserve((source.size() - current) / 8 + 1);
+    while (true) {
+        // Drain everything the last scanToken() call produced
+        fill(1);
+        for (; ringCount > 0; ringCount--, ringHead = (ringHead + 1) % ringSize) {
+            const Token& token = ring[ringHead];
+            tokens.push(token.type, token.loc.offset, token.lexeme.size());
+            if (token.type == TokenType::EndOfFile) {
+                ringCount = 0; // EndOfFile is re-emitted on demand
+                return tokens;
+            }
+        }
+    }
+}
+
+template <typename Trivia>
+Token Scanner<Trivia>::next() {
+    fill(1);
+    Token token = ring[ringHead];
+    ringHead = (ringHead + 1) % ringSize;
+    ringCount--;
+    return token;
+}
+
+template <typename Trivia>
+const Token& Scanner<Trivia>::peek(size_t k) {
+    fill(k + 1);
+    return ring[(ringHead + k) % ringSize];
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::fill(size_t count) {
+    while (ringCount < count) {
+        if (!includeStack.empty()) {
+            replayInclude();
+            continue;
+        }
+        if (isAtEnd()) {
+            emit(TokenType::EndOfFile, current, 0);
+            continue;
+        }
         scanToken();
     }
-    tokens.emplace_back(TokenType::EndOfFile, "", line);
-    // Error reporting is now handled by the compiler
-    return tokens;
 }
 
-bool Scanner::isAtEnd() {
+template <typename Trivia>
+void Scanner<Trivia>::emit(TokenType type, size_t offset, size_t length, Symbol symbol, uint32_t literal) {
+    push(Token(type, source.substr(offset, length), SourceLoc{static_cast<uint32_t>(offset)}, symbol, literal));
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::push(const Token& token) {
+    ring[(ringHead + ringCount) % ringSize] = token;
+    ringCount++;
+}
+
+template <typename Trivia>
+bool Scanner<Trivia>::isAtEnd() {
     return current >= source.length();
 }
 
-char Scanner::advance() {
+template <typename Trivia>
+char Scanner<Trivia>::advance() {
  return source[current++];
 }
-char Scanner::peek() {
+template <typename Trivia>
+char Scanner<Trivia>::peekChar() {
     if (isAtEnd()) return '\0';
     return source[current];
 }
 
-char Scanner::peekNext() {
+template <typename Trivia>
+char Scanner<Trivia>::peekNextChar() {
     if (current + 1 >= source.length()) return '\0';
     return source[current + 1];
 }
 
-void Scanner::addToken(TokenType type) {
-    string text = source.substr(start, current - start);
-    tokens.emplace_back(type, text, line);
+template <typename Trivia>
+void Scanner<Trivia>::addToken(TokenType type) {
+    emit(type, start, current - start);
 }
 
-void Scanner::skipWhitespace() {
-    while (true) {
-        char c = peek();
-        if (c == ' ' || c == '\t' || c == '\r') {
-            advance();
-        } else if (c == '\n') {
-            line++;
-            advance();
-        } else {
-            break;
-        }
+template <typename Trivia>
+void Scanner<Trivia>::addTrivia(TokenType type, size_t offset) {
+    if constexpr (Trivia::keepComments) emit(type, offset, current - offset);
+}
+
+namespace {
+
+// First-character classes driving the dispatch in scanToken().
+enum class CharClass : unsigned char {
+    Other,    // not part of the language; reported as unexpected
+    Blank,    // ' ', '\t', '\r', '\n'
+    Alpha,    // letters and '_': identifier or keyword
+    Digit,    // number, or an invalid identifier such as 3x
+    Sign,     // '+' / '-': operator, or the sign of a number
+    Slash,    // '/': divide, or the /^ and /@ comment openers
+    Quote,    // '"' or '\'': string or character constant
+    Operator, // operators and punctuation listed in operatorRules
+    NonAscii, // first byte of a UTF-8 sequence (or a stray byte)
+};
+
+// One- and two-character operators. `single` is the token for the
+// character on its own; Invalid means a lone character emits nothing.
+struct OperatorRule {
+    char second;
+    TokenType paired;
+    TokenType single;
+};
+
+constexpr array<CharClass, 256> makeCharClasses() {
+    array<CharClass, 256> table{};
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = CharClass::Alpha;
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = CharClass::Alpha;
+    for (int c = '0'; c <= '9'; ++c) table[c] = CharClass::Digit;
+    table['_'] = CharClass::Alpha;
+    table[' '] = table['\t'] = table['\r'] = table['\n'] = CharClass::Blank;
+    table['+'] = table['-'] = CharClass::Sign;
+    table['/'] = CharClass::Slash;
+    table['"'] = table['\''] = CharClass::Quote;
+    for (char c : {'*', '=', '!', '<', '>', '&', '|', '~', '{', '}', '[', ']', '(', ')', ';', ','}) {
+        table[static_cast<unsigned char>(c)] = CharClass::Operator;
     }
+    for (int c = 0x80; c <= 0xFF; ++c) table[c] = CharClass::NonAscii;
+    return table;
+}
+
+constexpr array<OperatorRule, 256> makeOperatorRules() {
+    array<OperatorRule, 256> table{};
+    table['*'] = {'\0', TokenType::Invalid, TokenType::Multiply};
+    table['='] = {'=', TokenType::Equal, TokenType::Assignment};
+    table['!'] = {'=', TokenType::NotEqual, TokenType::Invalid};
+    table['<'] = {'=', TokenType::LessEqual, TokenType::Less};
+    table['>'] = {'=', TokenType::GreaterEqual, TokenType::Greater};
+    table['&'] = {'&', TokenType::And, TokenType::Invalid};
+    table['|'] = {'|', TokenType::Or, TokenType::Invalid};
+    table['~'] = {'\0', TokenType::Invalid, TokenType::Not};
+    table['{'] = {'\0', TokenType::Invalid, TokenType::LeftBrace};
+    table['}'] = {'\0', TokenType::Invalid, TokenType::RightBrace};
+    table['['] = {'\0', TokenType::Invalid, TokenType::LeftBracket};
+    table[']'] = {'\0', TokenType::Invalid, TokenType::RightBracket};
+    table['('] = {'\0', TokenType::Invalid, TokenType::LeftParen};
+    table[')'] = {'\0', TokenType::Invalid, TokenType::RightParen};
+    table[';'] = {'\0', TokenType::Invalid, TokenType::Semicolon};
+    table[','] = {'\0', TokenType::Invalid, TokenType::Comma};
+    return table;
+}
+
+constexpr array<CharClass, 256> charClasses = makeCharClasses();
+constexpr array<OperatorRule, 256> operatorRules = makeOperatorRules();
+
+inline CharClass classOf(char c) {
+    return charClasses[static_cast<unsigned char>(c)];
+}
+
+inline bool isDigitChar(char c) {
+    return classOf(c) == CharClass::Digit;
+}
+
+inline bool isIdentChar(char c) {
+    CharClass k = classOf(c);
+    return k == CharClass::Alpha || k == CharClass::Digit;
+}
+
+// Whether a character constant's value is one code point.
+inline bool isSingleCharacter(string_view value) {
+    if (value.empty()) return false;
+    char32_t codepoint;
+    size_t length = unicode::decodeUtf8(value.data(), value.data() + value.size(), codepoint);
+    return length == value.size() || (length == 0 && value.size() == 1);
 }
 
-void Scanner::scanToken() {
+} // namespace
+
+template <typename Trivia>
+void Scanner<Trivia>::skipWhitespace() {
+    // Most tokens are followed by at most one blank; only longer runs
+    // (indentation, blank lines) are worth a vector scan.
+    if (classOf(peekChar()) != CharClass::Blank) return;
+    current++;
+    if (classOf(peekChar()) != CharClass::Blank) return;
+    const char* base = source.data();
+    current = simd::skipBlanks(base + current, base + source.length()) - base;
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::scanToken() {
     skipWhitespace();
     if (isAtEnd()) return;
     start = current;
 
     char c = advance();
 
-    // Handle + or - and check if followed by digit (signed number)
-    if (c == '+' || c == '-') {
-        if (isdigit(peek())) {
-            number(c);  // pass + or - to number()
-            return;
-        } else {
-            addToken((c == '+') ? TokenType::Plus : TokenType::Minus);
-            return;
-        }
-    }
-
-    // Single character tokens
-    switch (c) {
-        case '*': addToken(TokenType::Multiply); break;
-        case '=':
-            if (peek() == '=') { advance(); addToken(TokenType::Equal); }
-            else addToken(TokenType::Assignment);
+    switch (classOf(c)) {
+        case CharClass::Alpha:
+            identifier();
             break;
-        case '!':
-            if (peek() == '=') { advance(); addToken(TokenType::NotEqual); }
+        case CharClass::Digit:
+            // A digit followed by letters is an invalid identifier (3x)
+            if (classOf(peekChar()) == CharClass::Alpha) {
+                invalidIdentifier();
+            } else {
+                number(c);
+            }
             break;
-        case '<':
-            if (peek() == '=') { advance(); addToken(TokenType::LessEqual); }
-            else addToken(TokenType::Less);
+        case CharClass::Sign:
+            // + or - directly followed by a digit is a signed number
+            if (isDigitChar(peekChar())) {
+                number(c);
+            } else {
+                addToken((c == '+') ? TokenType::Plus : TokenType::Minus);
+            }
             break;
-        case '>':
-            if (peek() == '=') { advance(); addToken(TokenType::GreaterEqual); }
-            else addToken(TokenType::Greater);
+        case CharClass::Slash:
+            if (peekChar() == '^') { advance(); addTrivia(TokenType::SingleComment, start); singleLineComment(); }
+            else if (peekChar() == '@') { advance(); addTrivia(TokenType::SMultiComment, start); multiLineComment(); }
+            else { addToken(TokenType::Divide); }
             break;
-        case '&':
-            if (peek() == '&') { advance(); addToken(TokenType::And); }
+        case CharClass::Quote:
+            stringLiteral(c);
             break;
-        case '|':
-            if (peek() == '|') { advance(); addToken(TokenType::Or); }
+        case CharClass::Operator: {
+            const OperatorRule& rule = operatorRules[static_cast<unsigned char>(c)];
+            if (rule.second != '\0' && peekChar() == rule.second) {
+                advance();
+                addToken(rule.paired);
+            } else if (rule.single != TokenType::Invalid) {
+                addToken(rule.single);
+            }
             break;
-        case '~': addToken(TokenType::Not); break;
-        case '{': addToken(TokenType::LeftBrace); break;
-        case '}': addToken(TokenType::RightBrace); break;
-        case '[': addToken(TokenType::LeftBracket); break;
-        case ']': addToken(TokenType::RightBracket); break;
-        case '(': addToken(TokenType::LeftParen); break;
-        case ')': addToken(TokenType::RightParen); break;
-        case ';': addToken(TokenType::Semicolon); break;
-        case ',': addToken(TokenType::Comma); break;
-        case '/':
-            if (peek() == '^') { advance(); addToken(TokenType::SingleComment); singleLineComment(); }
-            else if (peek() == '@') { advance(); addToken(TokenType::SMultiComment); multiLineComment(); }
-            else { addToken(TokenType::Divide); }
+        }
+        case CharClass::Blank: // consumed by skipWhitespace()
             break;
-
-        default:
-            if (isalpha(c) || c == '_') {
+        case CharClass::NonAscii: {
+            const char* end = source.data() + source.length();
+            char32_t codepoint;
+            size_t length = unicode::decodeUtf8(source.data() + start, end, codepoint);
+            if (length == 0) {
+                current = start + unicode::invalidRunLength(source.data() + start, end);
+                error(DiagCode::InvalidUtf8);
+            } else if (unicode::isXidStart(codepoint)) {
+                current = start + length;
                 identifier();
+            } else {
+                current = start + length;
+                error(DiagCode::UnexpectedCharacter, length);
             }
-            else if (isdigit(c)) {
-                // Check if this is an invalid identifier (digit followed by letters)
-                if (isalpha(peek()) || peek() == '_') {
-                    invalidIdentifier(c);
-                } else {
-                    number(c);
-                }
-            }
-            else {
-                error("Unexpected character '" + std::string(1, c) + "'");
-            }
+            break;
+        }
+        case CharClass::Other:
+            error(DiagCode::UnexpectedCharacter, 1);
             break;
     }
 }
 
-void Scanner::invalidIdentifier(char firstChar) {
+template <typename Trivia>
+void Scanner<Trivia>::invalidIdentifier() {
     // Consume all alphanumeric characters
-    while (isalnum(peek()) || peek() == '_') advance();
-    string text = source.substr(start, current - start);
-    error("Invalid identifier '" + text + "' - identifiers cannot start with a digit");
+    while (isIdentChar(peekChar())) advance();
+    string_view text = source.substr(start, current - start);
+    error(DiagCode::InvalidIdentifier, text.size());
     // Still add the token but mark it as Invalid
-    tokens.emplace_back(TokenType::Invalid, text, line);
-}
-
-// Keyword map
-unordered_map<string, TokenType> keywords = {
-    {"IfTrue", TokenType::Condition},
-    {"Otherwise", TokenType::Condition},
-    {"Imw", TokenType::Integer},
-    {"SIMw", TokenType::SInteger},
-    {"Chj", TokenType::Character},
-    {"Series", TokenType::String},
-    {"IMwf", TokenType::Float},
-    {"SIMwf", TokenType::SFloat},
-    {"NOReturn", TokenType::Void},
-    {"RepeatWhen", TokenType::Loop},
-    {"Reiterate", TokenType::Loop},
-    {"Turnback", TokenType::Return},
-    {"OutLoop", TokenType::Break},
-    {"Loli", TokenType::Struct},
-    {"Include", TokenType::Include}
-};
+    emit(TokenType::Invalid, start, current - start);
+}
 
-void Scanner::identifier() {
-    while (isalnum(peek()) || peek() == '_') advance();
-    string text = source.substr(start, current - start);
-    auto it = keywords.find(text);
-    if (it != keywords.end()) {
-        addToken(it->second);
+template <typename Trivia>
+void Scanner<Trivia>::identifier() {
+    const char* p = source.data() + current;
+    const char* end = source.data() + source.length();
+    while (true) {
+        while (p < end && isIdentChar(*p)) ++p;
+        if (p == end || classOf(*p) != CharClass::NonAscii) break;
+        // Non-ASCII letters and marks continue the name (UAX #31).
+        char32_t codepoint;
+        size_t length = unicode::decodeUtf8(p, end, codepoint);
+        if (length == 0 || !unicode::isXidContinue(codepoint)) break;
+        p += length;
+    }
+    current = p - source.data();
+    string_view text = source.substr(start, current - start);
+    TokenType type = keywords::lookup(text);
+    if (includes && type == TokenType::Include) {
+        includeDirective();
+    } else if (names && type == TokenType::Identifier) {
+        emit(type, start, text.size(), names->intern(text));
     } else {
-        addToken(TokenType::Identifier);
+        emit(type, start, text.size());
     }
 }
 
-void Scanner::number(char firstChar) {
+template <typename Trivia>
+void Scanner<Trivia>::number(char firstChar) {
     bool isFloat = false;
     bool isSigned = false;
     size_t numberStart = start;
@@ -179,58 +326,477 @@ void Scanner::number(char firstChar) {
         advance();  // consume '+' or '-'
     }
 
-    while (isdigit(peek())) advance();
+    while (isDigitChar(peekChar())) advance();
 
-    if (peek() == '.' && isdigit(peekNext())) {
+    if (peekChar() == '.' && isDigitChar(peekNextChar())) {
         isFloat = true;
         advance(); // consume '.'
-        while (isdigit(peek())) advance();
+        while (isDigitChar(peekChar())) advance();
     }
 
-    // Extract full text (+4, -3.14, etc)
-    string text = source.substr(numberStart, current - numberStart);
+    // Full text (+4, -3.14, etc)
+    size_t length = current - numberStart;
+    string_view text = source.substr(numberStart, length);
 
     if (isFloat) {
+        uint32_t value = decodeFloat(text);
         if (isSigned)
-            tokens.emplace_back(TokenType::SignedFloatConstant, text, line);
+            emit(TokenType::SignedFloatConstant, numberStart, length, noSymbol, value);
         else
-            tokens.emplace_back(TokenType::FloatConstant, text, line);
+            emit(TokenType::FloatConstant, numberStart, length, noSymbol, value);
     } else {
+        uint32_t value = decodeInteger(text);
         if (isSigned)
-            tokens.emplace_back(TokenType::SignedIntegerConstant, text, line);
+            emit(TokenType::SignedIntegerConstant, numberStart, length, noSymbol, value);
         else
-            tokens.emplace_back(TokenType::IntgerConstant, text, line);
+            emit(TokenType::IntgerConstant, numberStart, length, noSymbol, value);
+    }
+}
+
+template <typename Trivia>
+uint32_t Scanner<Trivia>::decodeInteger(string_view text) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if (*first == '+') first++;  // from_chars only takes '-'
+    int64_t value = 0;
+    if (from_chars(first, last, value).ec == errc::result_out_of_range) {
+        error(DiagCode::IntegerOutOfRange, text.size());
+        value = text.front() == '-' ? numeric_limits<int64_t>::min() : numeric_limits<int64_t>::max();
     }
+    literals.integers.push_back(value);
+    return static_cast<uint32_t>(literals.integers.size() - 1);
 }
 
+template <typename Trivia>
+uint32_t Scanner<Trivia>::decodeFloat(string_view text) {
+    const char* first = text.data();
+    const char* last = first + text.size();
+    if (*first == '+') first++;
+    double value = 0;
+    if (from_chars(first, last, value).ec == errc::result_out_of_range) {
+        error(DiagCode::FloatOutOfRange, text.size());
+        value = text.front() == '-' ? -numeric_limits<double>::infinity() : numeric_limits<double>::infinity();
+    } else {
+        // Leading and trailing zeros do not count towards precision.
+        size_t digits = 0;
+        size_t significant = 0;
+        for (const char* p = first; p < last; ++p) {
+            if (*p == '.' || *p == '-') continue;
+            if (*p != '0' || digits > 0) digits++;
+            if (*p != '0') significant = digits;
+        }
+        if (significant > numeric_limits<double>::max_digits10) {
+            error(DiagCode::FloatRounded, text.size());
+        }
+    }
+    literals.floats.push_back(value);
+    return static_cast<uint32_t>(literals.floats.size() - 1);
+}
+
+
+template <typename Trivia>
+void Scanner<Trivia>::stringLiteral(char quote) {
+    string_view value;
+    if (!stringBody(quote, value)) {
+        emit(TokenType::Invalid, start, current - start);
+        return;
+    }
+    literals.strings.push_back(value);
+    uint32_t index = static_cast<uint32_t>(literals.strings.size() - 1);
+    emit(quote == '"' ? TokenType::StringConstant : TokenType::CharConstant,
+         start, current - start, noSymbol, index);
+}
+
+template <typename Trivia>
+bool Scanner<Trivia>::stringBody(char quote, string_view& value) {
+    const char* base = source.data();
+    const char* end = base + source.length();
+    string decoded;  // only filled once an escape shows up
+    bool escaped = false;
+    size_t run = current;
+    while (true) {
+        current = simd::findStringStop(base + current, end, quote) - base;
+        if (isAtEnd() || source[current] == '\n') {
+            error(quote == '"' ? DiagCode::UnterminatedString : DiagCode::UnterminatedCharacter);
+            checkUtf8(start + 1, current);
+            return false;
+        }
+        if (source[current] == quote) break;
+
+        // Backslash: copy the plain run before it, then the escaped character
+        decoded.append(base + run, base + current);
+        escaped = true;
+        current++;
+        if (isAtEnd() || source[current] == '\n') continue;  // reported as unterminated
+        char c = advance();
+        switch (c) {
+            case 'n': decoded += '\n'; break;
+            case 't': decoded += '\t'; break;
+            case 'r': decoded += '\r'; break;
+            case '0': decoded += '\0'; break;
+            case '\\': case '"': case '\'': decoded += c; break;
+            default:
+                error(DiagCode::UnknownEscape, 2, current - 2);
+                decoded += c;
+                break;
+        }
+        run = current;
+    }
+
+    if (escaped) {
+        decoded.append(base + run, base + current);
+        literals.decoded.push_back(std::move(decoded));
+        value = literals.decoded.back();
+    } else {
+        value = source.substr(start + 1, current - start - 1);
+    }
+    advance(); // closing quote
+    if (quote == '\'' && !isSingleCharacter(value)) {
+        error(DiagCode::CharacterLength);
+    }
+    checkUtf8(start + 1, current - 1);
+    return true;
+}
 
-void Scanner::singleLineComment() {
+template <typename Trivia>
+void Scanner<Trivia>::singleLineComment() {
     size_t commentStart = current;
-    while (peek() != '\n' && !isAtEnd()) advance();
-    string commentText = source.substr(commentStart, current - commentStart);
-    tokens.emplace_back(TokenType::CommentContent, commentText, line);
+    const char* base = source.data();
+    current = simd::findNewline(base + current, base + source.length()) - base;
+    checkUtf8(commentStart, current);
+    addTrivia(TokenType::CommentContent, commentStart);
 }
 
-void Scanner::multiLineComment() {
+template <typename Trivia>
+void Scanner<Trivia>::multiLineComment() {
     size_t commentStart = current;
-    while (!isAtEnd()) {
-        if (peek() == '@' && peekNext() == '/') {
-            string commentText = source.substr(commentStart, current - commentStart);
-            tokens.emplace_back(TokenType::CommentContent, commentText, line);
-            advance(); advance();  // consume @/
-            addToken(TokenType::EMultiComment);
+    const char* base = source.data();
+    current = simd::findCommentEnd(base + current, base + source.length()) - base;
+    if (!isAtEnd()) {
+        checkUtf8(commentStart, current);
+        addTrivia(TokenType::CommentContent, commentStart);
+        advance(); advance();  // consume @/
+        addTrivia(TokenType::EMultiComment, start);
+        return;
+    }
+
+    // If reached here → unterminated comment
+    unterminatedComment = start;
+    errorsBeforeUnterminated = errors.size();
+    error(DiagCode::UnterminatedComment);
+    checkUtf8(commentStart, current);
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::checkUtf8(size_t begin, size_t end) {
+    // Comment and literal bodies are skipped wholesale by the vector
+    // kernels, so their text is checked here in one pass.
+    const char* base = source.data();
+    for (const char* p = base + begin; p < base + end;) {
+        p = unicode::validateUtf8(p, base + end);
+        if (p == base + end) break;
+        SourceLoc at{static_cast<uint32_t>(p - base)};
+        errors.push_back(Diagnostic{DiagCode::InvalidUtf8, at, at});
+        errorCount++;
+        p += unicode::invalidRunLength(p, base + end);
+    }
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::error(DiagCode code, size_t textLength, size_t text) {
+    // Only the code and where to find the quoted text are kept; the message
+    // is worded if and when it is printed.
+    SourceLoc at{static_cast<uint32_t>(start)};
+    SourceLoc quoted{static_cast<uint32_t>(text == none ? start : text)};
+    errors.push_back(Diagnostic{code, at, quoted, static_cast<uint32_t>(textLength)});
+    if (!isWarning(code)) errorCount++;
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::expandIncludes(IncludeCache& cache, std::string directory) {
+    includes = &cache;
+    this->directory = std::move(directory);
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::includeDirective() {
+    // Include "file" [;]
+    SourceLoc at{static_cast<uint32_t>(start)};
+    skipWhitespace();
+    if (peekChar() != '"') {
+        includeErrors.push_back(Diagnostic{DiagCode::ExpectedIncludeName, at, at});
+        return;
+    }
+    start = current;
+    advance();
+    string_view name;
+    if (!stringBody('"', name)) return;  // unterminated; already an error
+    SourceLoc quoted{static_cast<uint32_t>(start + 1)};
+    uint32_t quotedLength = static_cast<uint32_t>(current - start - 2);
+    skipWhitespace();
+    if (peekChar() == ';') advance();
+    enterInclude(name, directory, at, quoted, quotedLength);
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::enterInclude(string_view name, const std::string& fromDirectory, SourceLoc at,
+                                   SourceLoc quoted, uint32_t quotedLength) {
+    DiagCode failure;
+    const IncludeUnit* unit = includes->load(name, fromDirectory, failure);
+    if (!unit) {
+        includeErrors.push_back(Diagnostic{failure, at, quoted, quotedLength});
+        return;
+    }
+    if (!included.insert(unit).second) return;  // implicit include guard
+
+    for (Diagnostic e : unit->errors) {
+        e.loc.offset += unit->base;
+        e.text.offset += unit->base;
+        includeErrors.push_back(e);
+    }
+    IncludeFrame frame{unit, 0, literals.integers.size(), literals.floats.size(), literals.strings.size()};
+    const LiteralTable& values = unit->literals;
+    literals.integers.insert(literals.integers.end(), values.integers.begin(), values.integers.end());
+    literals.floats.insert(literals.floats.end(), values.floats.begin(), values.floats.end());
+    literals.strings.insert(literals.strings.end(), values.strings.begin(), values.strings.end());
+    includeStack.push_back(frame);
+}
+
+template <typename Trivia>
+void Scanner<Trivia>::replayInclude() {
+    // The cached buffer is not scanned again: each call moves one token
+    // over, relocated past the unit's base, with its symbol and value.
+    IncludeFrame& frame = includeStack.back();
+    const IncludeUnit& unit = *frame.unit;
+    const TokenBuffer& tokens = unit.tokens;
+    size_t i = frame.next++;
+    TokenType type = tokens.type(i);
+    SourceLoc loc{unit.base + tokens.offset(i)};
+
+    if (type == TokenType::EndOfFile) {
+        includeStack.pop_back();
+        return;
+    }
+    if (type == TokenType::Include) {
+        if (tokens.type(frame.next) != TokenType::StringConstant) {
+            includeErrors.push_back(Diagnostic{DiagCode::ExpectedIncludeName, loc, loc});
             return;
         }
-        if (peek() == '\n') line++;
-        advance();
+        string_view name = literals.strings[frame.nextString++];
+        // The file name as written, without its quotes
+        SourceLoc quoted{unit.base + tokens.offset(frame.next) + 1};
+        uint32_t quotedLength = tokens.length(frame.next) - 2;
+        if (tokens.type(++frame.next) == TokenType::Semicolon) frame.next++;
+        // Entering may grow includeStack, so `frame` is done with.
+        enterInclude(name, unit.directory, loc, quoted, quotedLength);
+        return;
     }
 
-    // If reached here → unterminated comment
- error("Unterminated multi-line comment");
+    Symbol symbol = noSymbol;
+    uint32_t literal = noLiteral;
+    switch (type) {
+        case TokenType::Identifier:
+            if (names) symbol = names->intern(tokens.lexeme(i));
+            break;
+        case TokenType::IntgerConstant:
+        case TokenType::SignedIntegerConstant:
+            literal = static_cast<uint32_t>(frame.nextInteger++);
+            break;
+        case TokenType::FloatConstant:
+        case TokenType::SignedFloatConstant:
+            literal = static_cast<uint32_t>(frame.nextFloat++);
+            break;
+        case TokenType::StringConstant:
+        case TokenType::CharConstant:
+            literal = static_cast<uint32_t>(frame.nextString++);
+            break;
+        default:
+            break;
+    }
+    push(Token(type, tokens.lexeme(i), loc, symbol, literal));
 }
 
-void Scanner::error(const std::string& message) {
-    // Store error instead of printing immediately
-    errors.emplace_back(line, message);
-    errorCount++;
+namespace {
+
+// Below this size splitting the input costs more than it saves.
+constexpr size_t parallelThreshold = 4 * 1024 * 1024;
+
+} // namespace
+
+template <typename Trivia>
+TokenBuffer Scanner<Trivia>::scanTokensParallel(unsigned threadCount) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    size_t length = source.size() - current;
+    if (threadCount == 1 || length < parallelThreshold) return scanTokens();
+
+    // Split at newlines: apart from /@ comments no token spans a line break,
+    // so each chunk can be lexed on its own.
+    size_t chunkSize = std::max<size_t>(1024 * 1024, length / (threadCount * 4));
+    std::vector<size_t> chunkEnds;
+    for (size_t begin = current; begin < source.size();) {
+        size_t end = std::min(source.size(), begin + chunkSize);
+        if (end < source.size()) {
+            const char* base = source.data();
+            end = simd::findNewline(base + end, base + source.size()) - base;
+            if (end < source.size()) end++;
+        }
+        chunkEnds.push_back(end);
+        begin = end;
+    }
+
+    struct Piece {
+        TokenBuffer tokens;
+        std::vector<Diagnostic> errors;
+        size_t unterminatedComment = none;
+        size_t errorsBeforeUnterminated = 0;
+        size_t lastChunk = 0;
+    };
+    auto lexPiece = [this](size_t begin, size_t end, size_t lastChunk) {
+        Scanner scanner(source.substr(0, end), begin);
+        Piece piece;
+        piece.tokens = scanner.scanTokens();
+        piece.errors = std::move(scanner.errors);
+        piece.unterminatedComment = scanner.unterminatedComment;
+        piece.errorsBeforeUnterminated = scanner.errorsBeforeUnterminated;
+        piece.lastChunk = lastChunk;
+        return piece;
+    };
+
+    // Speculative pass: every chunk is lexed as if it started outside a
+    // comment, which is right unless an earlier chunk left a /@ open.
+    std::vector<Piece> pieces(chunkEnds.size());
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        for (size_t i = nextChunk++; i < chunkEnds.size(); i = nextChunk++) {
+            pieces[i] = lexPiece(i == 0 ? current : chunkEnds[i - 1], chunkEnds[i], i);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<size_t>(threadCount, chunkEnds.size()); ++t) pool.emplace_back(worker);
+    worker();
+    for (std::thread& thread : pool) thread.join();
+
+    // Stitch in order. When a piece ends inside an open comment, the chunks
+    // it swallows were guessed wrong: re-lex sequentially from the comment
+    // opener to the end of the chunk where the comment closes.
+    TokenBuffer tokens(source);
+    tokens.reserve(length / 8 + 1);
+    Piece piece = std::move(pieces[0]);
+    while (true) {
+        bool resume = piece.unterminatedComment != none && piece.lastChunk + 1 < chunkEnds.size();
+        // Drop the EndOfFile, and on resume also the dangling /@ before it.
+        size_t keep = piece.tokens.size() - (resume && Trivia::keepComments ? 2 : 1);
+        size_t keepErrors = resume ? piece.errorsBeforeUnterminated : piece.errors.size();
+        tokens.append(piece.tokens, 0, keep);
+        errors.insert(errors.end(), piece.errors.begin(), piece.errors.begin() + keepErrors);
+
+        if (resume) {
+            size_t opener = piece.unterminatedComment;
+            const char* base = source.data();
+            size_t close = simd::findCommentEnd(base + opener + 2, base + source.size()) - base;
+            size_t last = piece.lastChunk;
+            while (last + 1 < chunkEnds.size() && chunkEnds[last] < std::min(close + 2, source.size())) last++;
+            piece = lexPiece(opener, chunkEnds[last], last);
+            continue;
+        }
+
+        if (piece.lastChunk + 1 >= chunkEnds.size()) break;
+        piece = std::move(pieces[piece.lastChunk + 1]);
+    }
+
+    errorCount += static_cast<int>(std::count_if(errors.begin(), errors.end(),
+        [](const Diagnostic& e) { return !e.warning(); }));
+    current = source.size();
+    tokens.push(TokenType::EndOfFile, current, 0);
+    return tokens;
 }
+
+namespace {
+
+// Token boundaries where scanning can start from scratch: everything but
+// the body and closer of a /@ comment, which are emitted from inside it.
+inline bool isBoundary(TokenType type) {
+    return type != TokenType::CommentContent && type != TokenType::EMultiComment;
+}
+
+// Deciding where a token ends reads at most this many bytes past its end:
+// an identifier decodes the UTF-8 sequence after it to see whether it
+// continues the name ("1." only peeks at the digit after the dot).
+constexpr size_t lookahead = 4;
+
+} // namespace
+
+template <typename Trivia>
+RelexRange Scanner<Trivia>::relex(TokenBuffer& tokens, std::vector<Diagnostic>& errors,
+                          string_view source, const SourceEdit& edit) {
+    // Token ends never decrease, so the first token reaching the edit is
+    // found by bisection. Restart at the last boundary at or before it whose
+    // start, and so everything scanned to get there, lies clear of the edit.
+    size_t reach = 0;
+    for (size_t hi = tokens.size(); reach < hi;) {
+        size_t mid = (reach + hi) / 2;
+        if (tokens.offset(mid) + tokens.length(mid) < edit.offset) reach = mid + 1;
+        else hi = mid;
+    }
+    size_t first = 0;
+    size_t begin = 0;
+    for (size_t i = std::min(reach + 1, tokens.size()); i-- > 0;) {
+        TokenType type = tokens.type(i);
+        if (isBoundary(type) && type != TokenType::EndOfFile && tokens.offset(i) + lookahead <= edit.offset) {
+            first = i;
+            begin = tokens.offset(i);
+            break;
+        }
+    }
+    Scanner scanner(source, begin);
+
+    // Scan until a new boundary behind the edit sits where an old boundary
+    // sat before it: from there on both scans see the same text in the same
+    // state. Old EndOfFile always lines up, so the loop ends there at worst.
+    const std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(edit.inserted.size()) -
+                                 static_cast<std::ptrdiff_t>(edit.removed);
+    const size_t editEnd = edit.offset + edit.inserted.size();
+    TokenBuffer fresh(source);
+    size_t old = first;
+    size_t resync = tokens.size();
+    size_t newStop = none;
+    size_t oldStop = none;
+    while (true) {
+        Token token = scanner.next();
+        size_t offset = token.loc.offset;
+        if (isBoundary(token.type) && offset >= editEnd) {
+            size_t target = static_cast<size_t>(static_cast<std::ptrdiff_t>(offset) - delta);
+            while (old < tokens.size() && (!isBoundary(tokens.type(old)) || tokens.offset(old) < target)) old++;
+            if (old < tokens.size() && tokens.offset(old) == target) {
+                resync = old;
+                newStop = offset;
+                oldStop = target;
+                break;
+            }
+        }
+        fresh.push(token.type, offset, token.lexeme.size());
+        if (token.type == TokenType::EndOfFile) break;
+    }
+
+    // Errors are ordered by offset: swap the re-scanned stretch, shift the rest.
+    auto errorAt = [&errors](size_t offset) {
+        return static_cast<size_t>(std::partition_point(errors.begin(), errors.end(),
+            [offset](const Diagnostic& e) { return e.loc.offset < offset; }) - errors.begin());
+    };
+    size_t dropBegin = errorAt(begin);
+    size_t dropEnd = errorAt(oldStop);
+    for (size_t i = dropEnd; i < errors.size(); ++i) {
+        errors[i].loc.offset = static_cast<uint32_t>(errors[i].loc.offset + delta);
+        errors[i].text.offset = static_cast<uint32_t>(errors[i].text.offset + delta);
+    }
+    errors.erase(errors.begin() + dropBegin, errors.begin() + dropEnd);
+    auto keptEnd = std::partition_point(scanner.errors.begin(), scanner.errors.end(),
+        [newStop](const Diagnostic& e) { return e.loc.offset < newStop; });
+    errors.insert(errors.begin() + dropBegin, scanner.errors.begin(), keptEnd);
+
+    tokens.splice(first, resync, fresh, delta);
+    return {first, resync - first, fresh.size()};
+}
+
+template class Scanner<KeepTrivia>;
+template class Scanner<SkipTrivia>;
@@ -2,48 +2,192 @@
 #ifndef SCANNER_H
 #define SCANNER_H
 
+#include <array>
+#include <deque>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 #include <vector>
+#include "diagnostics.h"
+#include "interner.h"
 #include "token.h"
+#include "token_buffer.h"
 
-struct ScannerError {
-    int line;
-    std::string message;
-    ScannerError(int line, const std::string& message) : line(line), message(message) {}
+// Values of constants, decoded once while lexing. Integer constants
+// index `integers`, float constants `floats`, and string and character
+// constants `strings`. A string without escapes is a view into the
+// source; the others point into `decoded`, which never moves its elements.
+struct LiteralTable {
+    std::vector<int64_t> integers;
+    std::vector<double> floats;
+    std::vector<std::string_view> strings;
+    std::deque<std::string> decoded;
 };
 
+// An edit to a scanned source: `removed` bytes at `offset` were replaced
+// by `inserted`.
+struct SourceEdit {
+    size_t offset;
+    size_t removed;
+    std::string_view inserted;
+};
+
+// Tokens [first, first + inserted) of an updated buffer, which took the
+// place of `removed` tokens of the old one.
+struct RelexRange {
+    size_t first;
+    size_t removed;
+    size_t inserted;
+};
+
+class IncludeCache;
+struct IncludeUnit;
+
+// Trivia policies. With KeepTrivia comments come out as SingleComment /
+// SMultiComment, CommentContent and EMultiComment tokens, for tools that
+// show or rewrite them; with SkipTrivia they are still scanned (and still
+// reported when unterminated or ill-formed) but produce no tokens.
+struct KeepTrivia {
+    static constexpr bool keepComments = true;
+};
+struct SkipTrivia {
+    static constexpr bool keepComments = false;
+};
+
+// The policy is a template parameter so the choice costs nothing in the
+// scanning loop. Both instantiations are compiled once, in scanner.cpp.
+template <typename Trivia>
 class Scanner {
 public:
-    explicit Scanner(const std::string& source);
-    std::vector<Token> scanTokens();
+    // `source` is scanned in place and must outlive the scanner. With
+    // `names`, identifiers handed out by next() and peek() carry their
+    // interned Symbol; buffers from scanTokens() keep only offsets.
+    explicit Scanner(std::string_view source, StringInterner* names = nullptr);
+    // Scans the whole remaining source into a buffer.
+    TokenBuffer scanTokens();
+
+    // Same result as scanTokens() on a fresh scanner, token for token and
+    // error for error, but large sources are split at newlines and the
+    // pieces are lexed on `threadCount` threads (0: one per core).
+    TokenBuffer scanTokensParallel(unsigned threadCount = 0);
+
+    // Streaming interface: tokens are produced on demand into a small ring,
+    // so memory does not grow with the file. next() consumes one token and
+    // peek(k) looks k tokens ahead (k <= maxLookahead). Both keep returning
+    // EndOfFile once the source is exhausted. A reference from peek() is
+    // valid until the next call to next().
+    static constexpr size_t maxLookahead = 4;
+    Token next();
+    const Token& peek(size_t k);
     int getErrorCount() const { return errorCount; }
-    const std::vector<ScannerError>& getErrors() const { return errors; }
+    // Errors and warnings, in source order.
+    const std::vector<Diagnostic>& getErrors() const { return errors; }
+
+    // Splice included files into the stream handed out by next() and
+    // peek(): `Include "file";` is replaced by the tokens of `file`, taken
+    // from `cache`, so each file is scanned at most once per process.
+    // Relative names resolve against the including file's directory,
+    // `directory` for this source. A file is spliced in only the first
+    // time it is named, which also breaks include cycles.
+    void expandIncludes(IncludeCache& cache, std::string directory);
+    // Unreadable or malformed Include directives, and the errors of every
+    // file spliced in, in the order they were met.
+    const std::vector<Diagnostic>& getIncludeErrors() const { return includeErrors; }
 
+    // Decoded value of a numeric constant taken from next() or peek().
+    int64_t integerValue(const Token& token) const { return literals.integers[token.literal]; }
+    double floatValue(const Token& token) const { return literals.floats[token.literal]; }
+    std::string_view stringValue(const Token& token) const { return literals.strings[token.literal]; }
+    // Hands the decoded constants over, e.g. to keep them with a cached
+    // buffer; views into them stay valid.
+    LiteralTable takeLiterals() { return std::move(literals); }
+
+    // Incremental re-lexing. `tokens` and `errors` describe the source
+    // before `edit`, scanned with the same policy; `source` is the text
+    // after it. Scanning restarts at the
+    // last token boundary the edit cannot have influenced and stops as soon
+    // as a token boundary lines up with an old one behind the edit. Tokens
+    // and errors past that point are kept, shifted by the size of the edit.
+    // Only offsets of the old buffer are read, so the old text may already
+    // have been overwritten.
+    static RelexRange relex(TokenBuffer& tokens, std::vector<Diagnostic>& errors,
+                            std::string_view source, const SourceEdit& edit);
 
 private:
-    std::string source;
+    // Scans source[begin, source.size()).
+    Scanner(std::string_view source, size_t begin);
+
+    std::string_view source;
+    StringInterner* names = nullptr;
     size_t start = 0;
     size_t current = 0;
-    int line = 1;
+
+    // One scanToken() call emits at most 3 tokens (a kept /@ comment), so the
+    // ring holds maxLookahead + 3 entries, rounded up to a power of two.
+    static constexpr size_t ringSize = 8;
+    std::array<Token, ringSize> ring;
+    size_t ringHead = 0;
+    size_t ringCount = 0;
 
     bool isAtEnd();
     char advance();
-    char peek();
-    char peekNext();
+    char peekChar();
+    char peekNextChar();
+    void fill(size_t count);
+    void emit(TokenType type, size_t offset, size_t length,
+              Symbol symbol = noSymbol, uint32_t literal = noLiteral);
+    void push(const Token& token);
     void addToken(TokenType type);
+    // Emits comment token source[offset, current) if the policy keeps them.
+    void addTrivia(TokenType type, size_t offset);
     void scanToken();
     void skipWhitespace();
     void identifier();
-    void invalidIdentifier(char firstChar);
+    void invalidIdentifier();
     void number(char firstchar);
-    void stringLiteral();
+    uint32_t decodeInteger(string_view text);
+    uint32_t decodeFloat(string_view text);
+    void stringLiteral(char quote);
+    bool stringBody(char quote, std::string_view& value);
     void singleLineComment();
     void multiLineComment();
+    void checkUtf8(size_t begin, size_t end);
     int errorCount = 0;
-    void error(const string& message);
+    // Records `code` at the current token, quoting `textLength` bytes of
+    // source from `text` (the token start by default).
+    void error(DiagCode code, size_t textLength = 0, size_t text = none);
+
+    std::vector<Diagnostic> errors;
+    LiteralTable literals;
 
-    std::vector<Token> tokens;
-    std::vector<ScannerError> errors;
+    // An included unit being replayed. Its constants were appended to
+    // `literals`; the counters index the next one of each kind.
+    struct IncludeFrame {
+        const IncludeUnit* unit;
+        size_t next;
+        size_t nextInteger;
+        size_t nextFloat;
+        size_t nextString;
+    };
+    IncludeCache* includes = nullptr;
+    std::string directory;
+    std::vector<IncludeFrame> includeStack;
+    std::unordered_set<const IncludeUnit*> included;
+    std::vector<Diagnostic> includeErrors;
+    void includeDirective();
+    // `quoted` is the file name as written in the directive, for messages.
+    void enterInclude(std::string_view name, const std::string& fromDirectory, SourceLoc at,
+                      SourceLoc quoted, uint32_t quotedLength);
+    void replayInclude();
+
+    // Set when the source ends inside a /@ comment: where the comment
+    // opened and how many errors came before its "unterminated" error.
+    static constexpr size_t none = static_cast<size_t>(-1);
+    size_t unterminatedComment = none;
+    size_t errorsBeforeUnterminated = 0;
 };
 
+extern template class Scanner<KeepTrivia>;
+extern template class Scanner<SkipTrivia>;
+
 #endif
@@ -0,0 +1,276 @@
+#include "simd_scan.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SCAN_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define SIMD_SCAN_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace simd {
+namespace {
+
+#if defined(_MSC_VER) && !defined(__clang__)
+inline unsigned ctz32(unsigned x) {
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return index;
+}
+
+#else
+inline unsigned ctz32(unsigned x) { return static_cast<unsigned>(__builtin_ctz(x)); }
+#endif
+
+// ---- Scalar ---------------------------------------------------------------
+
+const char* skipBlanksScalar(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c != ' ' && c != '\n' && c != '\t' && c != '\r') break;
+    }
+    return p;
+}
+
+const char* findNewlineScalar(const char* p, const char* end) {
+    const void* hit = std::memchr(p, '\n', static_cast<size_t>(end - p));
+    return hit ? static_cast<const char*>(hit) : end;
+}
+
+const char* findCommentEndScalar(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        if (*p == '@' && p + 1 < end && p[1] == '/') return p;
+    }
+    return end;
+}
+
+const char* findStringStopScalar(const char* p, const char* end, char quote) {
+    for (; p < end; ++p) {
+        if (*p == quote || *p == '\\' || *p == '\n') return p;
+    }
+    return end;
+}
+
+const char* skipAsciiScalar(const char* p, const char* end) {
+    for (; p < end; ++p) {
+        if (static_cast<unsigned char>(*p) >= 0x80) return p;
+    }
+    return end;
+}
+
+// ---- SSE2: 16 bytes per step ----------------------------------------------
+
+#ifdef SIMD_SCAN_SSE2
+
+const char* skipBlanksSse2(const char* p, const char* end) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i nl = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i isBlank = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, nl)));
+        unsigned blankMask = static_cast<unsigned>(_mm_movemask_epi8(isBlank));
+        if (blankMask != 0xFFFFu) return p + ctz32(~blankMask);
+        p += 16;
+    }
+    return skipBlanksScalar(p, end);
+}
+
+const char* findNewlineSse2(const char* p, const char* end) {
+    const __m128i nl = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nl)));
+        if (mask) return p + ctz32(mask);
+        p += 16;
+    }
+    return findNewlineScalar(p, end);
+}
+
+const char* findCommentEndSse2(const char* p, const char* end) {
+    const __m128i at = _mm_set1_epi8('@');
+    const __m128i slash = _mm_set1_epi8('/');
+    // Each step also reads the byte after the block to match '@' '/'.
+    while (end - p >= 17) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+        unsigned hit = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(chunk, at), _mm_cmpeq_epi8(next, slash))));
+        if (hit) return p + ctz32(hit);
+        p += 16;
+    }
+    return findCommentEndScalar(p, end);
+}
+
+const char* findStringStopSse2(const char* p, const char* end, char quote) {
+    const __m128i q = _mm_set1_epi8(quote);
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i nl = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(chunk, q),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, backslash), _mm_cmpeq_epi8(chunk, nl)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(stop));
+        if (mask) return p + ctz32(mask);
+        p += 16;
+    }
+    return findStringStopScalar(p, end, quote);
+}
+
+const char* skipAsciiSse2(const char* p, const char* end) {
+    // The sign bits of the bytes are exactly the non-ASCII mask.
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(chunk));
+        if (mask) return p + ctz32(mask);
+        p += 16;
+    }
+    return skipAsciiScalar(p, end);
+}
+
+#endif // SIMD_SCAN_SSE2
+
+// ---- AVX2: 32 bytes per step ----------------------------------------------
+
+#ifdef SIMD_SCAN_AVX2
+
+__attribute__((target("avx2")))
+const char* skipBlanksAvx2(const char* p, const char* end) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i nl = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i isBlank = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, cr), _mm256_cmpeq_epi8(chunk, nl)));
+        unsigned blankMask = static_cast<unsigned>(_mm256_movemask_epi8(isBlank));
+        if (blankMask != 0xFFFFFFFFu) return p + __builtin_ctz(~blankMask);
+        p += 32;
+    }
+    return skipBlanksSse2(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* findNewlineAvx2(const char* p, const char* end) {
+    const __m256i nl = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, nl)));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return findNewlineSse2(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* findCommentEndAvx2(const char* p, const char* end) {
+    const __m256i at = _mm256_set1_epi8('@');
+    const __m256i slash = _mm256_set1_epi8('/');
+    while (end - p >= 33) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+        unsigned hit = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(chunk, at), _mm256_cmpeq_epi8(next, slash))));
+        if (hit) return p + __builtin_ctz(hit);
+        p += 32;
+    }
+    return findCommentEndSse2(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* findStringStopAvx2(const char* p, const char* end, char quote) {
+    const __m256i q = _mm256_set1_epi8(quote);
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i nl = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, q),
+            _mm256_or_si256(_mm256_cmpeq_epi8(chunk, backslash), _mm256_cmpeq_epi8(chunk, nl)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(stop));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return findStringStopSse2(p, end, quote);
+}
+
+__attribute__((target("avx2")))
+const char* skipAsciiAvx2(const char* p, const char* end) {
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(chunk));
+        if (mask) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+    return skipAsciiSse2(p, end);
+}
+
+#endif // SIMD_SCAN_AVX2
+
+// ---- Dispatch -------------------------------------------------------------
+
+struct Kernels {
+    const char* (*skipBlanks)(const char*, const char*);
+    const char* (*findNewline)(const char*, const char*);
+    const char* (*findCommentEnd)(const char*, const char*);
+    const char* (*findStringStop)(const char*, const char*, char);
+    const char* (*skipAscii)(const char*, const char*);
+    const char* name;
+};
+
+Kernels selectKernels() {
+#ifdef SIMD_SCAN_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {skipBlanksAvx2, findNewlineAvx2, findCommentEndAvx2, findStringStopAvx2, skipAsciiAvx2,
+                "avx2"};
+    }
+#endif
+#ifdef SIMD_SCAN_SSE2
+    return {skipBlanksSse2, findNewlineSse2, findCommentEndSse2, findStringStopSse2, skipAsciiSse2, "sse2"};
+#else
+    return {skipBlanksScalar, findNewlineScalar, findCommentEndScalar, findStringStopScalar, skipAsciiScalar,
+            "scalar"};
+#endif
+}
+
+const Kernels active = selectKernels();
+
+} // namespace
+
+const char* skipBlanks(const char* begin, const char* end) {
+    return active.skipBlanks(begin, end);
+}
+
+const char* findNewline(const char* begin, const char* end) {
+    return active.findNewline(begin, end);
+}
+
+const char* findCommentEnd(const char* begin, const char* end) {
+    return active.findCommentEnd(begin, end);
+}
+
+const char* findStringStop(const char* begin, const char* end, char quote) {
+    return active.findStringStop(begin, end, quote);
+}
+
+const char* skipAscii(const char* begin, const char* end) {
+    return active.skipAscii(begin, end);
+}
+
+const char* kernelName() {
+    return active.name;
+}
+
+} // namespace simd
@@ -0,0 +1,33 @@
+#ifndef SIMD_SCAN_H
+#define SIMD_SCAN_H
+
+#include <cstddef>
+
+// Byte-search kernels for the scanner's hot loops. Each function works on
+// [begin, end) and never reads outside it. The implementation is picked
+// once at startup: AVX2 (32 bytes per step) or SSE2 (16 bytes) on x86,
+// a scalar loop everywhere else.
+namespace simd {
+
+// First byte that is not ' ', '\t', '\r' or '\n' (or `end`).
+const char* skipBlanks(const char* begin, const char* end);
+
+// First '\n' (or `end`).
+const char* findNewline(const char* begin, const char* end);
+
+// Start of the first "@/" (or `end` if there is none).
+const char* findCommentEnd(const char* begin, const char* end);
+
+// First `quote`, '\\' or '\n' (or `end`): where a string or character
+// literal body stops being plain text.
+const char* findStringStop(const char* begin, const char* end, char quote);
+
+// First byte with the high bit set (or `end`): the end of a pure-ASCII run.
+const char* skipAscii(const char* begin, const char* end);
+
+// Name of the selected implementation ("avx2", "sse2" or "scalar").
+const char* kernelName();
+
+} // namespace simd
+
+#endif
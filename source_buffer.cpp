@@ -0,0 +1,129 @@
+#include "source_buffer.h"
+
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SourceBuffer::SourceBuffer(std::string text) : owned(std::move(text)) {
+    this->text = owned;
+}
+
+SourceBuffer::~SourceBuffer() {
+    release();
+}
+
+SourceBuffer::SourceBuffer(SourceBuffer&& other) noexcept {
+    *this = std::move(other);
+}
+
+SourceBuffer& SourceBuffer::operator=(SourceBuffer&& other) noexcept {
+    if (this == &other) return *this;
+    release();
+    owned = std::move(other.owned);
+    mapping = other.mapping;
+    mappingSize = other.mappingSize;
+    // A view into `owned` has to be re-pointed: short strings live inline.
+    text = mapping ? other.text : std::string_view(owned);
+    other.mapping = nullptr;
+    other.mappingSize = 0;
+    other.text = std::string_view();
+    return *this;
+}
+
+bool SourceBuffer::load(const std::string& filename) {
+    release();
+    if (filename != "-" && mapFile(filename)) {
+        return true;
+    }
+    return readFile(filename);
+}
+
+#ifdef _WIN32
+
+bool SourceBuffer::mapFile(const std::string& filename) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    void* view = nullptr;
+    if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &fileSize) &&
+        fileSize.QuadPart > 0) {
+        HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (fileMapping) {
+            view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(fileMapping);
+        }
+    }
+    CloseHandle(file);
+    if (!view) return false;
+
+    mapping = view;
+    mappingSize = static_cast<size_t>(fileSize.QuadPart);
+    text = std::string_view(static_cast<const char*>(view), mappingSize);
+    return true;
+}
+
+#else
+
+bool SourceBuffer::mapFile(const std::string& filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    void* view = MAP_FAILED;
+    // Pipes, character devices and empty files cannot be mapped.
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (view == MAP_FAILED) return false;
+
+    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+    mapping = view;
+    mappingSize = static_cast<size_t>(info.st_size);
+    text = std::string_view(static_cast<const char*>(view), mappingSize);
+    return true;
+}
+
+#endif
+
+bool SourceBuffer::readFile(const std::string& filename) {
+    std::ifstream file;
+    std::istream* in = &std::cin;
+    if (filename != "-") {
+        file.open(filename, std::ios::binary);
+        if (!file.is_open()) return false;
+        in = &file;
+    }
+
+    char chunk[64 * 1024];
+    while (in->read(chunk, sizeof(chunk)) || in->gcount() > 0) {
+        owned.append(chunk, static_cast<size_t>(in->gcount()));
+    }
+    text = owned;
+    return !in->bad();
+}
+
+void SourceBuffer::release() {
+    if (mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+#else
+        munmap(mapping, mappingSize);
+#endif
+        mapping = nullptr;
+        mappingSize = 0;
+    }
+    owned.clear();
+    text = std::string_view();
+}
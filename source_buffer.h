@@ -0,0 +1,43 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read-only bytes of one source file. Regular files are memory-mapped so the
+// scanner reads them in place; pipes, stdin ("-") and interactive input are
+// read into an owned string instead.
+class SourceBuffer {
+public:
+    SourceBuffer() = default;
+    explicit SourceBuffer(std::string text);
+    ~SourceBuffer();
+
+    SourceBuffer(SourceBuffer&& other) noexcept;
+    SourceBuffer& operator=(SourceBuffer&& other) noexcept;
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    // Replace the contents with the file `filename` ("-" reads stdin).
+    // Returns false if the file could not be opened or read.
+    bool load(const std::string& filename);
+
+    std::string_view view() const { return text; }
+    const char* data() const { return text.data(); }
+    size_t size() const { return text.size(); }
+    bool empty() const { return text.empty(); }
+    bool isMapped() const { return mapping != nullptr; }
+
+private:
+    std::string_view text;
+    std::string owned;
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+
+    bool mapFile(const std::string& filename);
+    bool readFile(const std::string& filename);
+    void release();
+};
+
+#endif
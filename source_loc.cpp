@@ -0,0 +1,32 @@
+#include "source_loc.h"
+#include "simd_scan.h"
+
+#include <algorithm>
+
+LineColumn LineTable::position(SourceLoc loc) const {
+    if (lineStarts.empty()) build();
+    auto next = std::upper_bound(lineStarts.begin(), lineStarts.end(), loc.offset);
+    size_t index = static_cast<size_t>(next - lineStarts.begin()) - 1;
+    return {static_cast<int>(index) + 1, static_cast<int>(loc.offset - lineStarts[index]) + 1};
+}
+
+void LineTable::build() const {
+    const char* begin = source.data();
+    const char* end = begin + source.size();
+    // Typical sources average well over 16 bytes per line.
+    lineStarts.reserve(source.size() / 16 + 1);
+    lineStarts.push_back(0);
+    for (const char* p = simd::findNewline(begin, end); p != end; p = simd::findNewline(p + 1, end)) {
+        lineStarts.push_back(static_cast<uint32_t>(p - begin + 1));
+    }
+}
+
+LineColumn LineCursor::position(SourceLoc loc) {
+    const std::vector<uint32_t>& starts = table.lineStarts;
+    if (starts.empty()) table.build();
+    if (loc.offset < starts[index]) {
+        index = static_cast<size_t>(std::upper_bound(starts.begin(), starts.end(), loc.offset) - starts.begin()) - 1;
+    }
+    while (index + 1 < starts.size() && starts[index + 1] <= loc.offset) ++index;
+    return {static_cast<int>(index) + 1, static_cast<int>(loc.offset - starts[index]) + 1};
+}
@@ -0,0 +1,53 @@
+#ifndef SOURCE_LOC_H
+#define SOURCE_LOC_H
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// A position in the source as a byte offset. Tokens and diagnostics carry
+// only this; line and column are worked out when something is printed.
+struct SourceLoc {
+    uint32_t offset = 0;
+};
+
+// 1-based line and column; the column counts bytes.
+struct LineColumn {
+    int line;
+    int column;
+};
+
+// Maps offsets of one source to lines and columns. The line starts are
+// found with a vectorized newline scan the first time a position is asked
+// for, so a run that prints no line numbers never scans for them.
+class LineTable {
+public:
+    // `source` must outlive the table.
+    explicit LineTable(std::string_view source) : source(source) {}
+
+    LineColumn position(SourceLoc loc) const;
+    int line(SourceLoc loc) const { return position(loc).line; }
+
+private:
+    friend class LineCursor;
+    void build() const;
+
+    std::string_view source;
+    mutable std::vector<uint32_t> lineStarts; // empty until the first query
+};
+
+// Positions of locations that mostly arrive in increasing order, as a
+// token stream's do: the cursor steps forward from the last line found
+// instead of searching the table each time.
+class LineCursor {
+public:
+    explicit LineCursor(const LineTable& table) : table(table) {}
+
+    LineColumn position(SourceLoc loc);
+
+private:
+    const LineTable& table;
+    size_t index = 0;
+};
+
+#endif
@@ -1,73 +1,72 @@
 #include "symbol_table.h"
-#include <stdexcept>
 #include <vector>
-#include <map>
 
 using std::vector;
 
 void SymbolTable::enterScope() {
-    variableScopes.emplace_back();
+    scopeStarts.push_back(static_cast<uint32_t>(bindings.size()));
 }
 
 void SymbolTable::exitScope() {
-    if (!variableScopes.empty()) {
-        variableScopes.pop_back();
+    if (!scopeStarts.empty()) {
+        while (bindings.size() > scopeStarts.back()) {
+            innermost[bindings.back().name] = bindings.back().shadowed;
+            bindings.pop_back();
+        }
+        scopeStarts.pop_back();
     }
 }
 
-bool SymbolTable::declareVariable(const string& name, SymbolType type) {
-    if (variableScopes.empty()) {
-        variableScopes.emplace_back();
+bool SymbolTable::declareVariable(Symbol name, SymbolType type) {
+    if (scopeStarts.empty()) {
+        enterScope();
     }
-    auto& currentScope = variableScopes.back();
-    if (currentScope.find(name) != currentScope.end() || functions.find(name) != functions.end()) {
+    if (inCurrentScope(innermostOf(name)) || functionOf(name) != none) {
         return false; // Variable or function already declared
     }
-    currentScope[name] = type;
+    if (name >= innermost.size()) {
+        innermost.resize(name + 1, none);
+    }
+    bindings.push_back({name, type, innermost[name]});
+    innermost[name] = static_cast<uint32_t>(bindings.size() - 1);
     return true;
 }
 
-bool SymbolTable::declareFunction(const string& name, SymbolType returnType, const vector<SymbolType>& paramTypes) {
-    if (functions.find(name) != functions.end() ||
-        (!variableScopes.empty() && variableScopes.back().find(name) != variableScopes.back().end())) {
+bool SymbolTable::declareFunction(Symbol name, SymbolType returnType, const vector<SymbolType>& paramTypes) {
+    if (functionOf(name) != none || inCurrentScope(innermostOf(name))) {
         return false; // Function or variable already declared
     }
-    functions.emplace(name, FunctionSignature(returnType, paramTypes));
+    if (name >= functionIndex.size()) {
+        functionIndex.resize(name + 1, none);
+    }
+    functionIndex[name] = static_cast<uint32_t>(functions.size());
+    functions.emplace_back(returnType, paramTypes);
     return true;
 }
 
-bool SymbolTable::exists(const string& name) const {
-    for (auto it = variableScopes.rbegin(); it != variableScopes.rend(); ++it) {
-        if (it->find(name) != it->end()) {
-            return true;
-        }
-    }
-    return false;
+bool SymbolTable::exists(Symbol name) const {
+    return innermostOf(name) != none;
 }
 
-bool SymbolTable::functionExists(const string& name) const {
-    return functions.find(name) != functions.end();
+bool SymbolTable::functionExists(Symbol name) const {
+    return functionOf(name) != none;
 }
 
-SymbolType SymbolTable::getVariableType(const string& name) const {
-    for (auto it = variableScopes.rbegin(); it != variableScopes.rend(); ++it) {
-        auto varIt = it->find(name);
-        if (varIt != it->end()) {
-            return varIt->second;
-        }
-    }
-    throw std::runtime_error("Variable '" + name + "' not found");
+SymbolType SymbolTable::getVariableType(Symbol name) const {
+    uint32_t binding = innermostOf(name);
+    return binding != none ? bindings[binding].type : SymbolType::Unknown;
 }
 
-SymbolTable::FunctionSignature SymbolTable::getFunctionSignature(const string& name) const {
-    auto it = functions.find(name);
-    if (it == functions.end()) {
-        throw std::runtime_error("Function '" + name + "' not found");
-    }
-    return it->second;
+const SymbolTable::FunctionSignature* SymbolTable::getFunctionSignature(Symbol name) const {
+    uint32_t index = functionOf(name);
+    return index != none ? &functions[index] : nullptr;
 }
 
 string SymbolTable::typeToString(SymbolType type) const {
+    return symbolTypeName(type);
+}
+
+const char* symbolTypeName(SymbolType type) {
     switch (type) {
         case SymbolType::Integer: return "Integer";
         case SymbolType::SInteger: return "SInteger";
@@ -1,13 +1,13 @@
 #ifndef SYMBOL_TABLE_H_INCLUDED
 #define SYMBOL_TABLE_H_INCLUDED
 
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <map>
+#include "interner.h"
 
 using std::string;
 using std::vector;
-using std::map;
 
 enum class SymbolType {
     Integer,
@@ -20,9 +20,14 @@ enum class SymbolType {
     Unknown,
 };
 
+// "Integer", "Float", ...; "Unknown" for anything else.
+const char* symbolTypeName(SymbolType type);
+
+// Names are interned Symbols, so every lookup is an index into a vector
+// rather than a string compare. `names` is only read to word errors.
 class SymbolTable {
 public:
-    SymbolTable() = default;
+    explicit SymbolTable(const StringInterner& names) : names(names) {}
 
     // Structure to store function signature
     struct FunctionSignature {
@@ -39,32 +44,51 @@ public:
     void exitScope();
 
     // Declare a variable with a given name and type
-    bool declareVariable(const string& name, SymbolType type);
+    bool declareVariable(Symbol name, SymbolType type);
 
     // Declare a function with name, return type, and parameter types
-    bool declareFunction(const string& name, SymbolType returnType, const vector<SymbolType>& paramTypes);
+    bool declareFunction(Symbol name, SymbolType returnType, const vector<SymbolType>& paramTypes);
 
     // Check if a variable exists in the current or outer scopes
-    bool exists(const string& name) const;
+    bool exists(Symbol name) const;
 
     // Check if a function exists
-    bool functionExists(const string& name) const;
+    bool functionExists(Symbol name) const;
 
-    // Get the type of a variable
-    SymbolType getVariableType(const string& name) const;
+    // Get the type of a variable; Unknown if it is not declared
+    SymbolType getVariableType(Symbol name) const;
 
-    // Get the function signature
-    FunctionSignature getFunctionSignature(const string& name) const;
+    // Get the function signature, or nullptr if there is no such function
+    const FunctionSignature* getFunctionSignature(Symbol name) const;
 
     // Convert SymbolType to string for error messages
     string typeToString(SymbolType type) const;
 
+    std::string_view name(Symbol symbol) const { return names.name(symbol); }
+
 private:
-    // Vector of maps for scoped variable storage
-    vector<map<string, SymbolType>> variableScopes;
+    static constexpr uint32_t none = UINT32_MAX;
+
+    // Variables live on one stack, innermost scope last. Each binding
+    // remembers the one it shadows, so leaving a scope pops its bindings
+    // and restores the outer ones.
+    struct Binding {
+        Symbol name;
+        SymbolType type;
+        uint32_t shadowed;
+    };
 
-    // Map to store function names and their signatures
-    map<string, FunctionSignature> functions;
+    // Binding or function index for `name`, or none.
+    uint32_t innermostOf(Symbol name) const { return name < innermost.size() ? innermost[name] : none; }
+    uint32_t functionOf(Symbol name) const { return name < functionIndex.size() ? functionIndex[name] : none; }
+    bool inCurrentScope(uint32_t binding) const { return binding != none && !scopeStarts.empty() && binding >= scopeStarts.back(); }
+
+    const StringInterner& names;
+    vector<Binding> bindings;
+    vector<uint32_t> scopeStarts;    // bindings.size() when each open scope began
+    vector<uint32_t> innermost;      // by Symbol: innermost binding
+    vector<uint32_t> functionIndex;  // by Symbol: index into functions
+    vector<FunctionSignature> functions;
 };
 
 #endif // SYMBOL_TABLE_H_INCLUDED
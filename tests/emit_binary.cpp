@@ -0,0 +1,148 @@
+// --emit-format=binary records must reach the file byte for byte. The
+// stream is opened in text mode, as stdout is, and the records are full of
+// 0x0A bytes: a token on line 10 of length 10, a rule at column 10 and
+// paths and messages with newlines in them. On Windows each of those would
+// become "\r\n" unless EventWriter switches the stream to binary mode. The
+// file is read back and every record is decoded and compared.
+//
+//     emit_binary <scratch file>
+
+#include "emit.h"
+#include "report.h"
+#include "scanner.h"
+#include "source_loc.h"
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Decodes the records of a binary dump, failing on the first byte that does
+// not match what was written.
+class Reader {
+public:
+    explicit Reader(std::string_view bytes) : bytes(bytes) {}
+
+    bool atEnd() const { return at == bytes.size(); }
+    bool failed() const { return failure; }
+
+    uint32_t u8() { return take(1); }
+    uint32_t u16() { return take(2); }
+    uint32_t u32() { return take(4); }
+    std::string_view text(size_t size) {
+        if (size > bytes.size() - at) return fail(), std::string_view();
+        std::string_view result = bytes.substr(at, size);
+        at += size;
+        return result;
+    }
+
+    // Starts a record and returns its kind; rest() runs to the end of it.
+    uint32_t record() {
+        uint32_t size = u32();
+        recordEnd = at + size;
+        if (recordEnd > bytes.size()) fail();
+        return u8();
+    }
+    std::string_view rest() { return text(recordEnd - at); }
+
+    void expect(bool ok) {
+        if (!ok) fail();
+    }
+
+private:
+    void fail() {
+        failure = true;
+        at = bytes.size();
+    }
+    uint32_t take(size_t size) {
+        if (size > bytes.size() - at) return fail(), 0;
+        uint32_t value = 0;
+        for (size_t i = 0; i < size; ++i) {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[at + i])) << (8 * i);
+        }
+        at += size;
+        return value;
+    }
+
+    std::string_view bytes;
+    size_t at = 0;
+    size_t recordEnd = 0;
+    bool failure = false;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: emit_binary <scratch file>\n");
+        return 2;
+    }
+    const char* path = argv[1];
+    const std::string source = std::string(9, '\n') + "abcdefghij = 10;\n";
+    const std::string_view mainPath = "dir\nmain.txt";
+    const std::string_view ruleName = "name\n";
+    const std::string_view includePath = "inc\n.txt";
+    const std::string_view message = "line one\nline two\r\n";
+
+    Scanner<KeepTrivia> scanner(source);
+    TokenBuffer tokens = scanner.scanTokens();
+    LineTable lines(source);
+
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) {
+        std::fprintf(stderr, "cannot write %s\n", path);
+        return 2;
+    }
+    {
+        EmitOptions options;
+        options.tokens = true;
+        options.parseEvents = true;
+        options.format = EmitFormat::Binary;
+        Report out(Verbosity::Quiet, file);
+        EventWriter writer(options, out);
+        writer.file(mainPath);
+        writer.tokens(tokens, lines);
+        writer.rule(ParseRule::Assignment, {{10, 10}, {}}, ruleName);
+        writer.error({{10, 10}, includePath}, message);
+    }
+    std::fclose(file);
+
+    std::string bytes;
+    file = std::fopen(path, "rb");
+    if (!file) {
+        std::fprintf(stderr, "cannot read %s\n", path);
+        return 2;
+    }
+    char chunk[4096];
+    for (size_t got; (got = std::fread(chunk, 1, sizeof(chunk), file)) > 0;) bytes.append(chunk, got);
+    std::fclose(file);
+    std::remove(path);
+
+    Reader in(bytes);
+    in.expect(in.text(4) == "P3EV" && in.u8() == 1);
+    in.expect(in.record() == 0 && in.rest() == mainPath);
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        LineColumn position = lines.position(tokens.loc(i));
+        in.expect(in.record() == 1);
+        in.expect(in.u8() == static_cast<uint32_t>(tokens.type(i)));
+        in.expect(in.u32() == tokens.offset(i) && in.u32() == tokens.length(i));
+        in.expect(in.u32() == static_cast<uint32_t>(position.line) &&
+                  in.u32() == static_cast<uint32_t>(position.column));
+        in.expect(in.rest() == tokens.lexeme(i));
+    }
+    in.expect(in.record() == 2 && in.u8() == static_cast<uint32_t>(ParseRule::Assignment));
+    in.expect(in.u32() == 10 && in.u32() == 10);
+    in.expect(in.text(in.u16()) == ruleName && in.rest().empty());
+    in.expect(in.record() == 3 && in.u32() == 10 && in.u32() == 10);
+    in.expect(in.text(in.u16()) == includePath && in.rest() == message);
+    in.expect(in.atEnd());
+
+    std::printf("%zu bytes, %zu token records\n", bytes.size(), tokens.size());
+    if (in.failed()) {
+        std::fprintf(stderr, "the binary dump does not read back as written\n");
+        return 1;
+    }
+    return 0;
+}
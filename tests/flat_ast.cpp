@@ -0,0 +1,293 @@
+// FlatAST must hold the tree it was built from: the same nodes in
+// pre-order, with the same type, operator, text and location, and every
+// child in its fixed slot. An independent recursive walk over the pointer
+// tree lists what each row and each slot should be, including the EMPTY
+// rows of absent children and the PARAMETER rows ahead of a function body.
+//
+// The trees are built by hand in an ASTContext, so that every absent-child
+// slot is covered (a missing Otherwise branch, For clauses, a Return value,
+// an initializer), and parsed from a generated source.
+//
+//     flat_ast <scratch file>
+
+#include "../HEADERS/flat_ast.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Row {
+    NodeType type;
+    TokenType op;
+    std::string_view text;
+    int line;
+    int column;
+    NodeIndex end;
+    std::vector<NodeIndex> children;
+};
+
+// The rows FlatAST should have for a tree, listed by following pointers.
+class Expected {
+public:
+    std::vector<Row> rows;
+
+    NodeIndex add(const ASTNode* node) {
+        if (!node) return close(row(NodeType::EMPTY, TokenType::ERROR, 0, 0, {}));
+
+        TokenType op = TokenType::ERROR;
+        std::string_view text;
+        const NodeList<Parameter>* parameters = nullptr;
+        std::vector<const ASTNode*> children;
+        switch (node->type) {
+            case NodeType::BLOCK:
+                for (const ASTNode* statement : static_cast<const BlockNode*>(node)->statements) {
+                    children.push_back(statement);
+                }
+                break;
+            case NodeType::FUNCTION_DECL: {
+                auto function = static_cast<const FunctionDeclNode*>(node);
+                op = function->returnType;
+                text = function->name;
+                parameters = &function->parameters;
+                children = {function->body};
+                break;
+            }
+            case NodeType::NORETURN_FUNC: {
+                auto function = static_cast<const NOReturnFuncNode*>(node);
+                text = function->name;
+                parameters = &function->parameters;
+                children = {function->body};
+                break;
+            }
+            case NodeType::VARIABLE_DECL: {
+                auto decl = static_cast<const VariableDeclNode*>(node);
+                op = decl->varType;
+                text = decl->name;
+                children = {decl->initializer};
+                break;
+            }
+            case NodeType::IF_STMT: {
+                auto stmt = static_cast<const IfStmtNode*>(node);
+                children = {stmt->condition, stmt->thenBranch, stmt->elseBranch};
+                break;
+            }
+            case NodeType::WHILE_STMT: {
+                auto stmt = static_cast<const WhileStmtNode*>(node);
+                children = {stmt->condition, stmt->body};
+                break;
+            }
+            case NodeType::REPEATWHEN_STMT: {
+                auto stmt = static_cast<const RepeatWhenStmtNode*>(node);
+                children = {stmt->condition, stmt->body};
+                break;
+            }
+            case NodeType::FOR_STMT: {
+                auto stmt = static_cast<const ForStmtNode*>(node);
+                children = {stmt->initializer, stmt->condition, stmt->increment, stmt->body};
+                break;
+            }
+            case NodeType::RETURN_STMT:
+                children = {static_cast<const ReturnStmtNode*>(node)->value};
+                break;
+            case NodeType::BINARY_EXPR: {
+                auto expr = static_cast<const BinaryExprNode*>(node);
+                op = expr->op;
+                children = {expr->left, expr->right};
+                break;
+            }
+            case NodeType::UNARY_EXPR: {
+                auto expr = static_cast<const UnaryExprNode*>(node);
+                op = expr->op;
+                children = {expr->expr};
+                break;
+            }
+            case NodeType::LITERAL: {
+                auto literal = static_cast<const LiteralNode*>(node);
+                op = literal->literalType;
+                text = literal->value;
+                break;
+            }
+            case NodeType::IDENTIFIER:
+                text = static_cast<const IdentifierNode*>(node)->name;
+                break;
+            default:
+                break;
+        }
+
+        NodeIndex index = row(node->type, op, node->line, node->column, text);
+        if (parameters) {
+            for (const Parameter& parameter : *parameters) {
+                NodeIndex slot = close(row(NodeType::PARAMETER, parameter.type, node->line, node->column,
+                                           parameter.name));
+                rows[index].children.push_back(slot);
+            }
+        }
+        for (const ASTNode* child : children) {
+            NodeIndex slot = add(child);
+            rows[index].children.push_back(slot);
+        }
+        return close(index);
+    }
+
+private:
+    NodeIndex row(NodeType type, TokenType op, int line, int column, std::string_view text) {
+        rows.push_back({type, op, text, line, column, 0, {}});
+        return static_cast<NodeIndex>(rows.size() - 1);
+    }
+    NodeIndex close(NodeIndex index) {
+        rows[index].end = static_cast<NodeIndex>(rows.size());
+        return index;
+    }
+};
+
+// The first difference between `flat` and the rows of the tree under
+// `root`, or an empty string.
+std::string difference(const ASTNode* root, const FlatAST& flat) {
+    Expected expected;
+    if (root) expected.add(root);
+    if (flat.size() != expected.rows.size()) {
+        return std::to_string(flat.size()) + " rows, expected " + std::to_string(expected.rows.size());
+    }
+    for (NodeIndex i : flat.nodes()) {
+        const Row& row = expected.rows[i];
+        std::string at = "row " + std::to_string(i) + ": ";
+        if (flat.type(i) != row.type) return at + "type";
+        if (flat.op(i) != row.op) return at + "op";
+        if (flat.text(i) != row.text) return at + "text '" + std::string(flat.text(i)) + "'";
+        if (flat.line(i) != row.line || flat.column(i) != row.column) return at + "location";
+        if (flat.end(i) != row.end) return at + "end " + std::to_string(flat.end(i));
+        if (flat.subtree(i).first != i || flat.subtree(i).last != row.end) return at + "subtree";
+        if (flat.childCount(i) != row.children.size()) return at + "child count " + std::to_string(flat.childCount(i));
+        size_t slot = 0;
+        for (NodeIndex child : flat.children(i)) {
+            if (slot >= row.children.size() || child != row.children[slot]) {
+                return at + "children() slot " + std::to_string(slot);
+            }
+            if (flat.child(i, slot) != child) return at + "child(" + std::to_string(slot) + ")";
+            slot++;
+        }
+        if (slot != row.children.size()) return at + "children() stops early";
+    }
+    return {};
+}
+
+// A function and a no-return function with parameters, and every statement
+// with each of its children absent somewhere. Each node has its own line.
+ASTNode* handBuilt(ASTContext& context) {
+    int line = 0;
+    auto name = [&](const char* text) { return context.create<IdentifierNode>(context.intern(text), ++line, 3); };
+    auto number = [&](const char* text) {
+        return context.create<LiteralNode>(context.intern(text), TokenType::INTEGER_LITERAL, ++line, 4);
+    };
+    auto binary = [&](TokenType op, ExpressionNode* left, ExpressionNode* right) {
+        return context.create<BinaryExprNode>(op, left, right, ++line, 5);
+    };
+    auto block = [&](std::vector<ASTNode*> statements) {
+        auto node = context.create<BlockNode>(++line, 1);
+        node->statements = context.list(statements.data(), statements.size());
+        return node;
+    };
+
+    // x = a * 2 + -(b - 1) / c
+    ExpressionNode* nested =
+        binary(TokenType::PLUS, binary(TokenType::MULTIPLY, name("a"), number("2")),
+               binary(TokenType::DIVIDE,
+                      context.create<UnaryExprNode>(TokenType::MINUS, binary(TokenType::MINUS, name("b"), number("1")),
+                                                    ++line, 6),
+                      name("c")));
+    ASTNode* body = block({
+        context.create<VariableDeclNode>(context.intern("x"), TokenType::IMW, nested, ++line, 2),
+        context.create<VariableDeclNode>(context.intern("y"), TokenType::FLOAT, nullptr, ++line, 2),
+        // IfTrue without Otherwise, and with one
+        context.create<IfStmtNode>(binary(TokenType::LESS, name("a"), name("b")),
+                                   block({context.create<ReturnStmtNode>(name("x"), ++line, 7)}), nullptr, ++line, 2),
+        context.create<IfStmtNode>(name("a"), context.create<ReturnStmtNode>(nullptr, ++line, 7), block({}), ++line,
+                                   2),
+        // For with no clauses at all, then with every clause
+        context.create<ForStmtNode>(nullptr, nullptr, nullptr, block({}), ++line, 2),
+        context.create<ForStmtNode>(
+            context.create<VariableDeclNode>(context.intern("i"), TokenType::IMW, number("0"), ++line, 8),
+            binary(TokenType::LESS, name("i"), number("10")),
+            binary(TokenType::ASSIGN, name("i"), binary(TokenType::PLUS, name("i"), number("1"))),
+            block({context.create<WhileStmtNode>(binary(TokenType::AND, name("a"), name("b")), nullptr, ++line, 9)}),
+            ++line, 2),
+        context.create<RepeatWhenStmtNode>(nullptr, block({}), ++line, 2),
+    });
+
+    Parameter twoParameters[] = {{context.intern("a"), TokenType::IMW}, {context.intern("b"), TokenType::FLOAT}};
+    Parameter oneParameter[] = {{context.intern("s"), TokenType::STRING}};
+    return block({
+        context.create<FunctionDeclNode>(context.intern("f"), TokenType::IMW, context.list(twoParameters, 2), body,
+                                         ++line, 1),
+        context.create<NOReturnFuncNode>(context.intern("g"), context.list(oneParameter, 1), block({}), ++line, 1),
+        context.create<FunctionDeclNode>(context.intern("h"), TokenType::FLOAT, NodeList<Parameter>(), nullptr,
+                                         ++line, 1),
+        context.create<VariableDeclNode>(context.intern("z"), TokenType::IMW, nullptr, ++line, 1),
+    });
+}
+
+// Functions of declarations, conditions and loops over nested expressions.
+void writeSource(const char* path) {
+    std::ofstream out(path);
+    for (int function = 0; function < 50; ++function) {
+        out << "Imw f" << function << "(Imw a, Float b) {\n"
+            << "    Imw x = a * (b + " << function << ") - -a / 2;\n"
+            << "    IfTrue (x < a && b != 1) { Return x; }\n"
+            << "    IfTrue (a) { x = 1; } Otherwise { x = 2; }\n"
+            << "    While (x > 0) { x = x - 1; }\n"
+            << "    RepeatWhen (x < 3) { x = x + 1; }\n"
+            << "    Return a + b * x;\n"
+            << "}\n";
+    }
+}
+
+bool check(const char* what, const ASTNode* root, const FlatAST& flat) {
+    std::string problem = difference(root, flat);
+    if (problem.empty()) return true;
+    std::fprintf(stderr, "%s: %s\n", what, problem.c_str());
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: flat_ast <scratch file>\n");
+        return 2;
+    }
+    int failures = 0;
+
+    ASTContext context;
+    ASTNode* root = handBuilt(context);
+    FlatAST flat(root);
+    if (!check("hand-built tree", root, flat)) failures++;
+    // A subtree on its own: the For with every clause.
+    const ASTNode* loop = static_cast<const BlockNode*>(
+                              static_cast<const FunctionDeclNode*>(static_cast<const BlockNode*>(root)->statements[0])
+                                  ->body)
+                              ->statements[5];
+    if (!check("For subtree", loop, FlatAST(loop))) failures++;
+    if (!check("null root", nullptr, FlatAST(nullptr))) failures++;
+
+    writeSource(argv[1]);
+    Scanner scanner;
+    if (!scanner.openFile(argv[1])) {
+        std::fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 2;
+    }
+    ASTContext parsedContext;
+    Parser parser(scanner, parsedContext);
+    std::cout.setstate(std::ios::failbit); // the parser reports every rule it matches
+    ASTNode* parsed = parser.parse();
+    std::cout.clear();
+    std::remove(argv[1]);
+    FlatAST parsedFlat(parsed);
+    if (parser.hasError() || !check("parsed source", parsed, parsedFlat)) failures++;
+
+    std::printf("%zu hand-built and %zu parsed rows checked\n", flat.size(), parsedFlat.size());
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+// An include that keeps changing in a long-running process must not use
+// up the include offsets: once superseded units are released, their room
+// is taken again. A new unit and the one it replaces are both live until
+// the next release, and a gap too small for the new size is passed over,
+// so the file needs the room of a few units, not of every version.
+//
+//     include_reload <scratch file>
+
+#include "include_cache.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: include_reload <scratch file>\n");
+        return 2;
+    }
+    std::filesystem::path scratch = std::filesystem::absolute(argv[1]);
+    std::string path = scratch.string();
+    std::string directory = scratch.parent_path().string();
+    std::string name = scratch.filename().string();
+
+    const std::string line = "Imw x = 1;\n";
+    const uint64_t largest = 7 * line.size() + 1; // with its EndOfFile
+    IncludeCache cache;
+    for (int round = 0; round < 1000; ++round) {
+        // A different size each time, so the change is seen even where
+        // modification times are coarse.
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            std::fprintf(stderr, "cannot write %s\n", path.c_str());
+            return 2;
+        }
+        for (int i = 0; i <= round % 7; ++i) std::fputs(line.c_str(), file);
+        std::fclose(file);
+
+        cache.releaseSuperseded();
+        DiagCode failure;
+        const IncludeUnit* unit = cache.load(name, directory, failure);
+        if (!unit) {
+            std::fprintf(stderr, "round %d: load failed (code %d)\n", round, static_cast<int>(failure));
+            return 1;
+        }
+        uint64_t end = unit->base + unit->source.size() + 1;
+        if (end > IncludeCache::firstBase + 4 * largest) {
+            std::fprintf(stderr, "round %d: unit ends at offset %llu, past the room of four units\n", round,
+                         static_cast<unsigned long long>(end));
+            return 1;
+        }
+    }
+    std::remove(path.c_str());
+    std::printf("1000 reloads, none past the first %llu bytes of offsets\n", static_cast<unsigned long long>(4 * largest));
+    return 0;
+}
@@ -0,0 +1,100 @@
+// Scanner::scanTokensParallel() must give what scanTokens() gives, token
+// for token and error for error, whatever the chunking. The inputs are
+// large enough to be split (4 MB and more) and put the constructs that make
+// splitting hard across chunk boundaries: /@ comments megabytes long,
+// megabyte-long lines and strings, unterminated strings and comments,
+// stray comment closers and ill-formed UTF-8.
+
+#include "scan_check.h"
+#include "scanner.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Ordinary code broken up by /@ comments of up to `longest` bytes, some of
+// them spanning several chunks; the last one is never closed.
+std::string longComments(Random& random, size_t size, size_t longest) {
+    std::string text;
+    while (text.size() < size) {
+        text += mixed(random, random.below(200000));
+        text += "/@";
+        size_t length = random.below(longest);
+        for (size_t i = 0; i < length; i += 64) {
+            text += random.below(4) == 0 ? "code = 1; \"str /^ '@ / @\n"
+                                         : "comment text ........................ @ /\n";
+        }
+        text += "@/";
+    }
+    text += "\nImw tail = 1;\n/@ left open at the end\n";
+    text += mixed(random, 100000);
+    return text;
+}
+
+// Lines, strings among them, longer than a chunk, and unterminated strings
+// that run to the end of such a line.
+std::string longLines(Random& random, size_t size) {
+    std::string text;
+    while (text.size() < size) {
+        text += mixed(random, random.below(100000));
+        size_t length = 1024 * 1024 + random.below(1024 * 1024);
+        switch (random.below(3)) {
+            case 0:
+                text += "Series s = \"" + std::string(length, 'z') + "\";\n";
+                break;
+            case 1:
+                text += "Series s = \"" + std::string(length, 'q') + "\n";
+                break;
+            default:
+                for (size_t i = 0; i < length; i += 16) text += "a = b + c * 7; ";
+                text += '\n';
+                break;
+        }
+    }
+    return text;
+}
+
+template <typename Trivia>
+bool matches(const char* input, const std::string& source, unsigned threads) {
+    Scanner<Trivia> sequential(source);
+    TokenBuffer expected = sequential.scanTokens();
+    Scanner<Trivia> parallel(source);
+    TokenBuffer actual = parallel.scanTokensParallel(threads);
+
+    std::string problem = difference(expected, sequential.getErrors(), actual, parallel.getErrors());
+    if (problem.empty() && sequential.getErrorCount() != parallel.getErrorCount()) problem = "error counts differ";
+    if (!problem.empty()) {
+        std::fprintf(stderr, "%s, %s, %u threads: %s\n", input, Trivia::keepComments ? "KeepTrivia" : "SkipTrivia",
+                     threads, problem.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    Random random(0x5eed);
+    struct Input {
+        const char* name;
+        std::string source;
+    };
+    const Input inputs[] = {
+        {"mixed", mixed(random, 6 * 1024 * 1024)},
+        {"long comments", longComments(random, 8 * 1024 * 1024, 3 * 1024 * 1024)},
+        {"many comments", longComments(random, 6 * 1024 * 1024, 300 * 1024)},
+        {"long lines", longLines(random, 7 * 1024 * 1024)},
+    };
+
+    int failures = 0;
+    for (const Input& input : inputs) {
+        for (unsigned threads : {2u, 7u}) {
+            if (!matches<KeepTrivia>(input.name, input.source, threads)) failures++;
+            if (!matches<SkipTrivia>(input.name, input.source, threads)) failures++;
+        }
+        std::printf("%s: %zu bytes checked\n", input.name, input.source.size());
+    }
+    return failures == 0 ? 0 : 1;
+}
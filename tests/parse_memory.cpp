@@ -0,0 +1,81 @@
+// Peak memory of a default compile must not grow with the token count: the
+// parser streams its tokens and no TokenBuffer of the whole file may be
+// built or kept on that path.
+//
+// The input is deeply parenthesized assignments, which are almost all
+// tokens and hardly any tree: about one token per byte, and a TokenBuffer
+// takes 9 bytes per token. A compile that holds such a buffer peaks near
+// ten times the source size; a streaming one at the mapped source plus a
+// small tree.
+//
+//     parse_memory <scratch file>
+
+#include "compiler.h"
+#include "report.h"
+
+#include <cstdio>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/resource.h>
+
+namespace {
+
+size_t peakBytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: parse_memory <scratch file>\n");
+        return 2;
+    }
+    const char* path = argv[1];
+
+    // Written in pieces, so making the input does not raise the peak itself.
+    constexpr size_t depth = 40;
+    constexpr size_t statements = 250000;
+    std::string statement = "x = " + std::string(depth, '(') + "1" + std::string(depth, ')') + ";\n";
+    std::FILE* out = std::fopen(path, "wb");
+    if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", path);
+        return 2;
+    }
+    std::fputs("Imw x;\n", out);
+    for (size_t i = 0; i < statements; ++i) std::fputs(statement.c_str(), out);
+    std::fclose(out);
+    size_t sourceBytes = 7 + statement.size() * statements;
+
+    size_t before = peakBytes();
+    {
+        Report report(Verbosity::Quiet);
+        Compiler compiler(report);
+        compiler.compile(path);
+    }
+    size_t growth = peakBytes() - before;
+    std::remove(path);
+
+    // The mapped source, the tree (a statement and a constant per line) and
+    // the allocator's slack stay well under 3x; a token buffer alone is 9x.
+    size_t limit = sourceBytes * 3;
+    std::printf("source %zu KB, peak growth %zu KB, limit %zu KB\n", sourceBytes / 1024, growth / 1024,
+                limit / 1024);
+    if (growth > limit) {
+        std::fprintf(stderr, "parse memory grows with the token count\n");
+        return 1;
+    }
+    return 0;
+}
+
+#else
+
+int main() {
+    std::printf("peak memory is only measured on Linux; skipped\n");
+    return 77;
+}
+
+#endif
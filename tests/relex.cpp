@@ -0,0 +1,130 @@
+// Scanner::relex() must leave the buffer and errors that a full rescan of
+// the edited source would give. Random edits (insertions, deletions and
+// replacements, many of them opening or closing comments and strings, or
+// cutting UTF-8 sequences in two) are applied one after another to one
+// source, and each result is compared with a fresh scan. The interactive
+// mode's edits, appended lines, are checked the same way.
+
+#include "scan_check.h"
+#include "scanner.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+// Text that changes how what follows it is scanned.
+const char* const insertions[] = {
+    "/@", "@/", "/^", "\"", "'", "\n", " ", "Imw", "x", "12", ".", "5", ".5", "e+", "\\", "ü", "é", "\xcc\x81",
+    "\xff", ";", "{", "=", "&&",
+};
+
+template <typename Trivia>
+bool check(const char* what, size_t step, const TokenBuffer& tokens, const std::vector<Diagnostic>& errors,
+           const std::string& source) {
+    Scanner<Trivia> scanner(source);
+    TokenBuffer expected = scanner.scanTokens();
+    std::string problem = difference(expected, scanner.getErrors(), tokens, errors);
+    if (problem.empty()) return true;
+    std::fprintf(stderr, "%s, %s, edit %zu: %s\n", what, Trivia::keepComments ? "KeepTrivia" : "SkipTrivia", step,
+                 problem.c_str());
+    return false;
+}
+
+// Short sources whose token ends depend on the bytes after them.
+const char* const shortSources[] = {
+    "x = 12.;\ny = 3.5e;\n",
+    "Imw größe = abc\xcc\x81;\n",
+    "a/@ c @/b /^ d\ne",
+    "s = \"q\\\"\" 'c' \"open\n",
+    "9lives && ~x != y <= z\n",
+};
+
+// Every insertion from `insertions` and every deletion of up to 3 bytes,
+// at every offset of `text`, each applied to a fresh scan.
+template <typename Trivia>
+bool everyEdit(const std::string& text) {
+    Scanner<Trivia> initial(text);
+    const TokenBuffer original = initial.scanTokens();
+    const std::vector<Diagnostic> originalErrors = initial.getErrors();
+    size_t step = 0;
+    for (size_t offset = 0; offset <= text.size(); ++offset) {
+        for (size_t edit = 0; edit < sizeof(insertions) / sizeof(insertions[0]) + 3; ++edit, ++step) {
+            size_t removed = edit < 3 ? std::min(edit + 1, text.size() - offset) : 0;
+            std::string_view inserted = edit < 3 ? "" : insertions[edit - 3];
+            std::string source = text;
+            source.replace(offset, removed, inserted);
+            TokenBuffer tokens = original;
+            std::vector<Diagnostic> errors = originalErrors;
+            SourceEdit change{offset, removed, std::string_view(source).substr(offset, inserted.size())};
+            Scanner<Trivia>::relex(tokens, errors, source, change);
+            if (!check<Trivia>("every edit", step, tokens, errors, source)) return false;
+        }
+    }
+    return true;
+}
+
+template <typename Trivia>
+bool randomEdits(Random& random, size_t count) {
+    std::string source = mixed(random, 20000);
+    Scanner<Trivia> initial(source);
+    TokenBuffer tokens = initial.scanTokens();
+    std::vector<Diagnostic> errors = initial.getErrors();
+
+    for (size_t step = 0; step < count; ++step) {
+        // Half the edits land right after a token, where the scanner
+        // looked ahead to decide where the token ends.
+        size_t offset = random.below(source.size() + 1);
+        if (random.below(2) == 0) {
+            size_t token = random.below(tokens.size());
+            offset = tokens.offset(token) + tokens.length(token) + random.below(3);
+            offset = std::min(offset, source.size());
+        }
+        size_t removed = std::min(source.size() - offset, random.below(3) == 0 ? random.below(40) : size_t(0));
+        std::string inserted;
+        if (random.below(4) != 0) inserted = insertions[random.below(sizeof(insertions) / sizeof(insertions[0]))];
+        if (random.below(8) == 0) inserted += mixed(random, random.below(200));
+
+        source.replace(offset, removed, inserted);
+        SourceEdit edit{offset, removed, std::string_view(source).substr(offset, inserted.size())};
+        Scanner<Trivia>::relex(tokens, errors, source, edit);
+        if (!check<Trivia>("random edits", step, tokens, errors, source)) return false;
+    }
+    return true;
+}
+
+template <typename Trivia>
+bool appendedLines(Random& random, size_t count) {
+    std::string source;
+    TokenBuffer tokens = Scanner<Trivia>(source).scanTokens();
+    std::vector<Diagnostic> errors;
+
+    for (size_t step = 0; step < count; ++step) {
+        size_t end = source.size();
+        source += fragments[random.below(sizeof(fragments) / sizeof(fragments[0]))];
+        if (random.below(10) == 0) source.insert(source.size() - 1, "/@");
+        Scanner<Trivia>::relex(tokens, errors, source, {end, 0, std::string_view(source).substr(end)});
+        if (!check<Trivia>("appended lines", step, tokens, errors, source)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    Random random(0x2e1e);
+    int failures = 0;
+    for (const char* text : shortSources) {
+        if (!everyEdit<KeepTrivia>(text)) failures++;
+        if (!everyEdit<SkipTrivia>(text)) failures++;
+    }
+    if (!randomEdits<KeepTrivia>(random, 2000)) failures++;
+    if (!randomEdits<SkipTrivia>(random, 2000)) failures++;
+    if (!appendedLines<KeepTrivia>(random, 2000)) failures++;
+    if (!appendedLines<SkipTrivia>(random, 2000)) failures++;
+    std::printf("%d edit sequences differ from a full rescan\n", failures);
+    return failures == 0 ? 0 : 1;
+}
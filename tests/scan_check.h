@@ -0,0 +1,90 @@
+#ifndef TESTS_SCAN_CHECK_H
+#define TESTS_SCAN_CHECK_H
+
+// Shared by the scanner checks: generated inputs, from a fixed seed so that
+// a failure can be reproduced, and a comparison of two scans.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "diagnostics.h"
+#include "token_buffer.h"
+
+// xorshift64
+class Random {
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+    size_t below(size_t bound) { return static_cast<size_t>(next() % bound); }
+
+private:
+    uint64_t state;
+};
+
+// Whole lines of code, well-formed or not: every kind of token, constants
+// with escapes and out of range, comments of both kinds, stray characters
+// and comment closers, Unicode identifiers and ill-formed UTF-8.
+inline const char* const fragments[] = {
+    "Imw count = 42;\n",
+    "SIMwf ratio = -3.25, scale = +1e3;\n",
+    "Series s = \"tab\\there \\\"quoted\\\"\";\n",
+    "Chj c = '\\n';\n",
+    "Chj bad = 'ab';\n",
+    "Series open = \"no end;\n",
+    "IfTrue (a <= b && ~c) { a = a + 1; } Otherwise { b = b * 2; }\n",
+    "RepeatWhen (i != 10) { i = i - 1; }\n",
+    "/^ a line comment with /@ inside\n",
+    "x = 1; /@ short @/ y = 2;\n",
+    "stray @/ closer and $ # ? characters\n",
+    "Imw größe = 3; Imw 变量 = größe;\n",
+    "Imw bad\xff\xfe = 1;\n",
+    "9lives = 99999999999999999999999;\n",
+    "IMwf big = 1e999, precise = 0.12345678901234567890123;\n",
+    "\n",
+    "   \t  \n",
+};
+
+// Random fragments, at least `size` bytes of them.
+inline std::string mixed(Random& random, size_t size) {
+    std::string text;
+    while (text.size() < size) text += fragments[random.below(sizeof(fragments) / sizeof(fragments[0]))];
+    return text;
+}
+
+// The first difference between two scans of the same source, or an empty
+// string if they agree token for token and error for error.
+inline std::string difference(const TokenBuffer& expected, const std::vector<Diagnostic>& expectedErrors,
+                              const TokenBuffer& actual, const std::vector<Diagnostic>& actualErrors) {
+    for (size_t i = 0; i < expected.size() && i < actual.size(); ++i) {
+        if (expected.type(i) != actual.type(i) || expected.offset(i) != actual.offset(i) ||
+            expected.length(i) != actual.length(i)) {
+            return "token " + std::to_string(i) + " is " + std::to_string(actual.length(i)) + " bytes at " +
+                   std::to_string(actual.offset(i)) + ", expected " + std::to_string(expected.length(i)) +
+                   " bytes at " + std::to_string(expected.offset(i));
+        }
+    }
+    if (expected.size() != actual.size()) {
+        return std::to_string(actual.size()) + " tokens, expected " + std::to_string(expected.size());
+    }
+    for (size_t i = 0; i < expectedErrors.size() && i < actualErrors.size(); ++i) {
+        const Diagnostic& e = expectedErrors[i];
+        const Diagnostic& a = actualErrors[i];
+        if (e.code != a.code || e.loc.offset != a.loc.offset || e.text.offset != a.text.offset ||
+            e.textLength != a.textLength || e.arg != a.arg) {
+            return "error " + std::to_string(i) + " at offset " + std::to_string(a.loc.offset) +
+                   ", expected offset " + std::to_string(e.loc.offset);
+        }
+    }
+    if (expectedErrors.size() != actualErrors.size()) {
+        return std::to_string(actualErrors.size()) + " errors, expected " + std::to_string(expectedErrors.size());
+    }
+    return {};
+}
+
+#endif // TESTS_SCAN_CHECK_H
@@ -0,0 +1,56 @@
+// A main source of IncludeCache::firstBase bytes or more cannot be given
+// 32-bit offsets below the included files' and must be refused before it
+// is scanned. The file is sparse, so it takes no disk space.
+//
+//     source_size <scratch file>
+
+#include "compiler.h"
+#include "include_cache.h"
+#include "report.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: source_size <scratch file>\n");
+        return 2;
+    }
+    const char* path = argv[1];
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        std::fprintf(stderr, "cannot write %s\n", path);
+        return 2;
+    }
+    std::fputs("Imw x = 1;\n", file);
+    std::fclose(file);
+    std::error_code ec;
+    std::filesystem::resize_file(path, IncludeCache::firstBase, ec);
+    if (ec) {
+        std::printf("cannot make a %u-byte file here (%s); skipped\n", IncludeCache::firstBase, ec.message().c_str());
+        std::remove(path);
+        return 77;
+    }
+
+    std::FILE* out = std::tmpfile();
+    bool compiled;
+    {
+        Report report(Verbosity::Errors, out);
+        Compiler compiler(report);
+        compiled = compiler.compile(path);
+    }
+    std::remove(path);
+
+    std::string printed(256, '\0');
+    std::rewind(out);
+    printed.resize(std::fread(&printed[0], 1, printed.size(), out));
+    std::fclose(out);
+    std::printf("%s", printed.c_str());
+    if (compiled || printed.find("too large") == std::string::npos) {
+        std::fprintf(stderr, "a %u-byte source was not refused\n", IncludeCache::firstBase);
+        return 1;
+    }
+    return 0;
+}
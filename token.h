@@ -1,10 +1,15 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
+#include <cstdint>
+#include <initializer_list>
 #include <string>
+#include <string_view>
+#include "interner.h"
+#include "source_loc.h"
 using namespace std;
 
-enum class TokenType
+enum class TokenType : unsigned char
 {
     // Keywords
     Integer,
@@ -74,14 +79,48 @@ enum class TokenType
     Invalid
 };
 
+// A set of token types, as a bit mask.
+class TokenSet
+{
+public:
+    constexpr TokenSet() = default;
+    constexpr TokenSet(std::initializer_list<TokenType> types)
+    {
+        for (TokenType type : types) bits |= bit(type);
+    }
+
+    constexpr bool contains(TokenType type) const { return (bits & bit(type)) != 0; }
+    constexpr TokenSet operator|(TokenSet other) const
+    {
+        TokenSet result;
+        result.bits = bits | other.bits;
+        return result;
+    }
+
+private:
+    static constexpr uint64_t bit(TokenType type) { return uint64_t{1} << static_cast<unsigned>(type); }
+    uint64_t bits = 0;
+};
+static_assert(static_cast<unsigned>(TokenType::Invalid) < 64, "TokenSet holds 64 token types");
+
+// Marks a token without a decoded numeric value.
+constexpr uint32_t noLiteral = UINT32_MAX;
+
+// `lexeme` is a view into the scanned source, so the source buffer must
+// outlive every token taken from it. Copy it into a string only when the
+// text is needed on its own (diagnostics, symbol names).
 struct Token
 {
     TokenType type;
-    string lexeme;
-    int line;
+    string_view lexeme;
+    SourceLoc loc; // where the lexeme starts
+    Symbol symbol;    // interned name of an Identifier, else noSymbol
+    uint32_t literal; // constants: index into the scanner's LiteralTable
 
-    Token(TokenType type, const string &lexeme, int line)
-        : type(type), lexeme(lexeme), line(line) {}
+    Token() : type(TokenType::EndOfFile), symbol(noSymbol), literal(noLiteral) {}
+    Token(TokenType type, string_view lexeme, SourceLoc loc,
+          Symbol symbol = noSymbol, uint32_t literal = noLiteral)
+        : type(type), lexeme(lexeme), loc(loc), symbol(symbol), literal(literal) {}
 };
 
 string tokenTypeToString(TokenType type);
@@ -0,0 +1,87 @@
+#ifndef TOKEN_BUFFER_H
+#define TOKEN_BUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "token.h"
+
+// Token stream stored as parallel arrays (struct-of-arrays). Type checks in
+// the parser walk the dense one-byte `types` column instead of striding over
+// whole Token structs. Lexemes are offset/length pairs into the scanned
+// source, which must outlive the buffer; the offset doubles as the token's
+// SourceLoc, so lines are left to a LineTable.
+class TokenBuffer {
+public:
+    TokenBuffer() = default;
+    explicit TokenBuffer(string_view source) : source(source) {}
+
+    void reserve(size_t count) {
+        types.reserve(count);
+        offsets.reserve(count);
+        lengths.reserve(count);
+    }
+
+    void push(TokenType type, size_t offset, size_t length) {
+        types.push_back(type);
+        offsets.push_back(static_cast<uint32_t>(offset));
+        lengths.push_back(static_cast<uint32_t>(length));
+    }
+
+    // Append tokens [begin, end) of `other` (same source).
+    void append(const TokenBuffer& other, size_t begin, size_t end) {
+        types.insert(types.end(), other.types.begin() + begin, other.types.begin() + end);
+        offsets.insert(offsets.end(), other.offsets.begin() + begin, other.offsets.begin() + end);
+        lengths.insert(lengths.end(), other.lengths.begin() + begin, other.lengths.begin() + end);
+    }
+
+    // Replace tokens [begin, end) with all of `replacement`, which was scanned
+    // from an edited copy of the source, and shift the tokens after them by
+    // `offsetDelta` bytes. The buffer then refers to the replacement's source.
+    void splice(size_t begin, size_t end, const TokenBuffer& replacement, std::ptrdiff_t offsetDelta) {
+        spliceColumn(types, begin, end, replacement.types);
+        spliceColumn(offsets, begin, end, replacement.offsets);
+        spliceColumn(lengths, begin, end, replacement.lengths);
+        for (size_t i = begin + replacement.size(); i < size(); ++i) {
+            offsets[i] = static_cast<uint32_t>(offsets[i] + offsetDelta);
+        }
+        source = replacement.source;
+    }
+
+    size_t size() const { return types.size(); }
+    bool empty() const { return types.empty(); }
+
+    TokenType type(size_t i) const { return types[i]; }
+    uint32_t offset(size_t i) const { return offsets[i]; }
+    uint32_t length(size_t i) const { return lengths[i]; }
+    SourceLoc loc(size_t i) const { return SourceLoc{offsets[i]}; }
+    // Where the token ends; multi-line comments are reported on this line.
+    SourceLoc endLoc(size_t i) const { return SourceLoc{offsets[i] + lengths[i]}; }
+    string_view lexeme(size_t i) const { return source.substr(offsets[i], lengths[i]); }
+
+    // Materialize one token; prefer the column accessors in loops.
+    Token operator[](size_t i) const { return Token(types[i], lexeme(i), loc(i)); }
+
+    string_view text() const { return source; }
+
+private:
+    template <typename T>
+    static void spliceColumn(std::vector<T>& column, size_t begin, size_t end, const std::vector<T>& with) {
+        size_t common = std::min(end - begin, with.size());
+        std::copy(with.begin(), with.begin() + common, column.begin() + begin);
+        if (common < end - begin) {
+            column.erase(column.begin() + begin + common, column.begin() + end);
+        } else {
+            column.insert(column.begin() + end, with.begin() + common, with.end());
+        }
+    }
+
+    string_view source;
+    std::vector<TokenType> types;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "unicode.h"
+#include "simd_scan.h"
+#include "xid_tables.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace unicode {
+namespace {
+
+inline bool isContinuation(unsigned char byte) {
+    return (byte & 0xC0) == 0x80;
+}
+
+template <size_t N>
+bool inRanges(const CodepointRange (&ranges)[N], char32_t codepoint) {
+    // First range ending at or after the code point.
+    const CodepointRange* range = std::lower_bound(std::begin(ranges), std::end(ranges), codepoint,
+        [](const CodepointRange& r, char32_t c) { return r.last < c; });
+    return range != std::end(ranges) && range->first <= codepoint;
+}
+
+} // namespace
+
+size_t decodeUtf8(const char* p, const char* end, char32_t& codepoint) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(p);
+    size_t available = static_cast<size_t>(end - p);
+    if (available == 0) return 0;
+    unsigned char lead = s[0];
+    if (lead < 0x80) {
+        codepoint = lead;
+        return 1;
+    }
+
+    // Lead byte ranges per RFC 3629; the second byte's bounds rule out
+    // overlong forms (E0, F0), surrogates (ED) and values past U+10FFFF (F4).
+    size_t length;
+    unsigned char low = 0x80;
+    unsigned char high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        codepoint = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        codepoint = lead & 0x0F;
+        if (lead == 0xE0) low = 0xA0;
+        if (lead == 0xED) high = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        codepoint = lead & 0x07;
+        if (lead == 0xF0) low = 0x90;
+        if (lead == 0xF4) high = 0x8F;
+    } else {
+        return 0;
+    }
+    if (available < length || s[1] < low || s[1] > high) return 0;
+    for (size_t i = 1; i < length; ++i) {
+        if (!isContinuation(s[i])) return 0;
+        codepoint = (codepoint << 6) | (s[i] & 0x3F);
+    }
+    return length;
+}
+
+const char* validateUtf8(const char* begin, const char* end) {
+    const char* p = begin;
+    while (true) {
+        p = simd::skipAscii(p, end);
+        // Stay scalar through a stretch of multi-byte text; go back to the
+        // vector scan once ASCII shows up again.
+        while (p < end && static_cast<unsigned char>(*p) >= 0x80) {
+            char32_t codepoint;
+            size_t length = decodeUtf8(p, end, codepoint);
+            if (length == 0) return p;
+            p += length;
+        }
+        if (p == end) return end;
+    }
+}
+
+size_t invalidRunLength(const char* p, const char* end) {
+    const char* q = p + 1;
+    while (q < end && isContinuation(static_cast<unsigned char>(*q))) ++q;
+    return static_cast<size_t>(q - p);
+}
+
+bool isXidStart(char32_t codepoint) {
+    return inRanges(xidStartRanges, codepoint);
+}
+
+bool isXidContinue(char32_t codepoint) {
+    return inRanges(xidContinueRanges, codepoint);
+}
+
+} // namespace unicode
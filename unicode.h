@@ -0,0 +1,31 @@
+#ifndef UNICODE_H
+#define UNICODE_H
+
+#include <cstddef>
+
+// UTF-8 decoding and the Unicode identifier classes (UAX #31). Sources
+// are mostly ASCII, so callers keep ASCII on their own fast paths and
+// only come here for bytes with the high bit set.
+namespace unicode {
+
+// Decodes the well-formed UTF-8 sequence at `p` into `codepoint` and
+// returns its length (1-4). Returns 0 for an ill-formed sequence:
+// a stray continuation byte, a truncated sequence, an overlong form,
+// a surrogate, or a value past U+10FFFF.
+size_t decodeUtf8(const char* p, const char* end, char32_t& codepoint);
+
+// Start of the first ill-formed sequence in [begin, end) (or `end`).
+// ASCII runs are skipped a vector at a time.
+const char* validateUtf8(const char* begin, const char* end);
+
+// Length of the run of bytes an ill-formed sequence at `p` spans: the
+// offending byte and any continuation bytes after it.
+size_t invalidRunLength(const char* p, const char* end);
+
+// Whether a non-ASCII code point may start or continue an identifier.
+bool isXidStart(char32_t codepoint);
+bool isXidContinue(char32_t codepoint);
+
+} // namespace unicode
+
+#endif